@@ -0,0 +1,48 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Tiny benchmark harness shared by the bench/*.cpp files (built with `make bench`).
+
+// Keeps a value alive so the optimizer cannot drop the measured work.
+inline volatile std::uint64_t g_benchSink = 0;
+
+// Run fn once and return the elapsed wall time in milliseconds.
+template<typename Fn>
+double timeMs(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+// Print one result line: name, elapsed time and throughput in million operations per second.
+inline void report(const std::string& name, double ms, double ops) {
+    std::cout << "  " << name << ": " << ms << " ms";
+    if (ms > 0.0) {
+        std::cout << " (" << (ops / ms / 1000.0) << " Mops/s)";
+    }
+    std::cout << "\n";
+}
+
+// Value of a `key=value` argument given after the suite names
+// (e.g. `make bench BENCH_ARGS="workload grid=4096 density=0.02"`), or `fallback` if absent.
+std::string_view benchOption(std::string_view key, std::string_view fallback = {});
+double benchOption(std::string_view key, double fallback);
+// true if any `key=value` argument was given
+bool benchHasOptions();
+
+// Benchmark suites
+void bench_environment_map();
+void bench_shm_transport();
+void bench_logging();
+void bench_messages();
+void bench_nearest_idle();
+void bench_simulation();
+void bench_cell_set();
+void bench_feed_file();
+void bench_checkpoint();
+void bench_workload();
@@ -0,0 +1,66 @@
+// bench_cell_set.cpp
+// Queue dedupe on the dense-dirt stress case: every dirty cell of a 1024x1024 floor at 50% dirt is
+// inserted in scan order, looked up again and erased in FIFO order - the previous
+// std::set<std::pair<int,int>> versus CellSet with the dense bitset and the sparse hash backends.
+
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "bench.hpp"
+#include "control_unit/cell_set.hpp"
+
+namespace {
+
+constexpr int kGrid = 1024;
+
+template<typename Insert, typename Contains, typename Erase>
+double churn(const std::vector<Position>& cells, Insert insert, Contains contains, Erase erase) {
+    return timeMs([&] {
+        std::uint64_t hits = 0;
+        for (const Position& p : cells) {
+            hits += insert(p);
+        }
+        for (const Position& p : cells) {
+            hits += insert(p);     // duplicate detections are rejected
+            hits += contains(p);
+        }
+        for (const Position& p : cells) {
+            erase(p);
+        }
+        g_benchSink = g_benchSink + hits;
+    });
+}
+
+}  // namespace
+
+void bench_cell_set() {
+    std::mt19937 rng(5);
+    std::bernoulli_distribution dirty(0.5);
+    std::vector<Position> cells;
+    for (int y = 0; y < kGrid; ++y) {
+        for (int x = 0; x < kGrid; ++x) {
+            if (dirty(rng)) {
+                cells.push_back({x, y});
+            }
+        }
+    }
+    const double ops = 4.0 * static_cast<double>(cells.size());
+    std::cout << "  " << kGrid << "x" << kGrid << " floor, " << cells.size() << " dirty cells\n";
+
+    std::set<std::pair<int, int>> tree;
+    report("std::set<pair<int,int>>", churn(cells,
+        [&](Position p) { return tree.insert({p.x, p.y}).second; },
+        [&](Position p) { return tree.count({p.x, p.y}) > 0; },
+        [&](Position p) { tree.erase({p.x, p.y}); }), ops);
+
+    for (MapStorage storage : {MapStorage::DENSE, MapStorage::SPARSE}) {
+        CellSet set;
+        set.reset(kGrid, kGrid, storage);
+        report(storage == MapStorage::DENSE ? "CellSet (dense bitset)" : "CellSet (sparse hash)", churn(cells,
+            [&](Position p) { return set.insert(p); },
+            [&](Position p) { return set.contains(p); },
+            [&](Position p) { set.erase(p); }), ops);
+    }
+}
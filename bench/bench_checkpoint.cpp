@@ -0,0 +1,59 @@
+// bench_checkpoint.cpp
+// Snapshot write and restore on an 8192x8192 floor that is 90% done (~67k of 671k dirt cells
+// left), for both map backends, against re-seeding the whole floor from the original feed.
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "bench.hpp"
+#include "control_unit/checkpoint.hpp"
+#include "workload.hpp"
+
+void bench_checkpoint() {
+    WorkloadSpec spec;
+    spec.width = 8192;
+    spec.height = 8192;
+    spec.density = 0.01;
+    const BootstrapFeed feed = generateFeed(spec);
+    const std::string path = "/tmp/cleaning_robots_bench_" + std::to_string(::getpid()) + ".ckpt";
+
+    for (MapStorage storage : {MapStorage::DENSE, MapStorage::SPARSE}) {
+        EnvironmentMap map;
+        const double seedMs = timeMs([&] { map.initializeGrid(feed.gridWidth, feed.gridHeight, feed.dirtSpots, storage); });
+
+        // the first 90% of the spots are cleaned; of the rest, half wait for a washer, half for a vacuum
+        CheckpointState state;
+        state.patterns = {"serpentine"};
+        state.detectorProgress = {static_cast<std::uint64_t>(map.cellCount() * 9 / 10)};
+        const std::size_t done = feed.dirtSpots.size() * 9 / 10;
+        for (std::size_t i = 0; i < feed.dirtSpots.size(); ++i) {
+            const Position p = feed.dirtSpots[i];
+            if (i < done || i % 2 == 0) {
+                map.markVacuumed(p);
+            }
+            if (i < done) {
+                map.markWashed(p);
+            } else {
+                (i % 2 == 0 ? state.washerQueue : state.vacuumQueue).push_back(p);
+            }
+        }
+
+        const double writeMs = timeMs([&] { writeCheckpoint(path, map, state); });
+        struct stat st {};
+        ::stat(path.c_str(), &st);
+        EnvironmentMap restored;
+        CheckpointState restoredState;
+        const double restoreMs = timeMs([&] { readCheckpoint(path, restored, restoredState); });
+        g_benchSink = g_benchSink + restoredState.vacuumQueue.size();
+
+        std::cout << "  " << (storage == MapStorage::DENSE ? "dense" : "sparse") << " map, "
+                  << (state.vacuumQueue.size() + state.washerQueue.size()) << " cells left, snapshot "
+                  << (static_cast<double>(st.st_size) / 1024.0) << " KiB\n";
+        report("seed from the full feed (cells)", seedMs, static_cast<double>(feed.dirtSpots.size()));
+        report("write snapshot (cells left)", writeMs, static_cast<double>(state.vacuumQueue.size() + state.washerQueue.size()));
+        report("restore snapshot (cells left)", restoreMs, static_cast<double>(state.vacuumQueue.size() + state.washerQueue.size()));
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,137 @@
+// bench_environment_map.cpp
+// Compares hasDirt/markVacuumed throughput of the packed EnvironmentMap against the
+// previous nested-vector layout (one std::vector per row, one int-sized enum per cell).
+
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "environment/environment_map.hpp"
+
+namespace {
+
+// The pre-packing storage layout, kept here only as a baseline for comparison.
+class NestedVectorMap {
+public:
+    enum class State : int { CLEAN = 0, DIRTY = 1, VACUUMED = 2 };
+
+    void initializeGrid(int width, int height, const std::vector<Position>& dirtSpots) {
+        width_ = width;
+        height_ = height;
+        grid_.assign(height_, std::vector<State>(width_, State::CLEAN));
+        for (const auto& spot : dirtSpots) {
+            grid_[spot.y][spot.x] = State::DIRTY;
+        }
+    }
+    bool hasDirt(Position p) const {
+        if (!inBounds(p) || grid_.empty()) {
+            return false;
+        }
+        return grid_[p.y][p.x] == State::DIRTY;
+    }
+    bool markVacuumed(Position p) {
+        if (!inBounds(p) || grid_.empty()) {
+            return false;
+        }
+        State& cell = grid_[p.y][p.x];
+        if (cell != State::DIRTY) {
+            return false;
+        }
+        cell = State::VACUUMED;
+        return true;
+    }
+    std::size_t storageBytes() const {
+        return grid_.size() * (sizeof(std::vector<State>) + static_cast<std::size_t>(width_) * sizeof(State));
+    }
+
+private:
+    bool inBounds(Position p) const { return p.x >= 0 && p.y >= 0 && p.x < width_ && p.y < height_; }
+
+    int width_{0};
+    int height_{0};
+    std::vector<std::vector<State>> grid_;
+};
+
+std::vector<Position> randomSpots(int width, int height, std::size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> xs(0, width - 1);
+    std::uniform_int_distribution<int> ys(0, height - 1);
+    std::vector<Position> spots;
+    spots.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        spots.push_back(Position{xs(rng), ys(rng)});
+    }
+    return spots;
+}
+
+template<typename Map>
+void runOne(const char* label, int width, int height, const std::vector<Position>& spots,
+            const std::vector<Position>& probes) {
+    Map map;
+    const double initMs = timeMs([&] { map.initializeGrid(width, height, spots); });
+    std::cout << " " << label << " (" << map.storageBytes() / (1024 * 1024) << " MiB)\n";
+    report("initializeGrid", initMs, static_cast<double>(width) * height);
+
+    std::uint64_t hits = 0;
+    const double scanMs = timeMs([&] {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                hits += map.hasDirt(Position{x, y}) ? 1 : 0;
+            }
+        }
+    });
+    report("hasDirt full scan", scanMs, static_cast<double>(width) * height);
+
+    const double randMs = timeMs([&] {
+        for (const auto& p : probes) {
+            hits += map.hasDirt(p) ? 1 : 0;
+        }
+    });
+    report("hasDirt random", randMs, static_cast<double>(probes.size()));
+
+    const double markMs = timeMs([&] {
+        for (const auto& p : spots) {
+            hits += map.markVacuumed(p) ? 1 : 0;
+        }
+    });
+    report("markVacuumed", markMs, static_cast<double>(spots.size()));
+    g_benchSink = g_benchSink + hits;
+}
+
+}
+
+void bench_environment_map() {
+    const int width = 8000;
+    const int height = 4000;   // 32M cells
+    const auto spots = randomSpots(width, height, 2000000, 1);
+    const auto probes = randomSpots(width, height, 4000000, 2);
+
+    std::cout << " floor " << width << "x" << height << ", " << spots.size() << " dirt spots\n";
+    runOne<NestedVectorMap>("nested vector (before)", width, height, spots, probes);
+    runOne<EnvironmentMap>("packed 2-bit (after)", width, height, spots, probes);
+
+    // huge, mostly-clean floor: only the sparse backend can hold it
+    const int hugeSide = 100000;   // 10^10 cells
+    const auto hugeSpots = randomSpots(hugeSide, hugeSide, 5000, 3);
+    const auto hugeProbes = randomSpots(hugeSide, hugeSide, 4000000, 4);
+    EnvironmentMap sparse;
+    const double initMs = timeMs([&] { sparse.initializeGrid(hugeSide, hugeSide, hugeSpots, MapStorage::SPARSE); });
+    std::cout << " sparse " << hugeSide << "x" << hugeSide << ", " << hugeSpots.size() << " dirt spots ("
+              << sparse.storageBytes() / 1024 << " KiB)\n";
+    report("initializeGrid", initMs, static_cast<double>(hugeSpots.size()));
+    std::uint64_t hits = 0;
+    const double randMs = timeMs([&] {
+        for (const auto& p : hugeProbes) {
+            hits += sparse.hasDirt(p) ? 1 : 0;
+        }
+    });
+    report("hasDirt random", randMs, static_cast<double>(hugeProbes.size()));
+    const double markMs = timeMs([&] {
+        for (const auto& p : hugeSpots) {
+            hits += sparse.markVacuumed(p) ? 1 : 0;
+            hits += sparse.markWashed(p) ? 1 : 0;
+        }
+    });
+    report("markVacuumed+markWashed", markMs, 2.0 * static_cast<double>(hugeSpots.size()));
+    g_benchSink = g_benchSink + hits;
+}
@@ -0,0 +1,63 @@
+// bench_feed_file.cpp
+// Startup cost of seeding a 4096x4096 floor with ~800k dirt spots: a text feed parsed into a
+// vector and handed to initializeGrid, versus memory-mapped binary feeds streamed into the map.
+
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "bench.hpp"
+#include "environment/feed_file.hpp"
+#include "workload.hpp"
+
+void bench_feed_file() {
+    WorkloadSpec spec;
+    spec.width = 4096;
+    spec.height = 4096;
+    spec.density = 0.05;
+    const BootstrapFeed feed = generateFeed(spec);
+    const double spots = static_cast<double>(feed.dirtSpots.size());
+
+    const std::string base = "/tmp/cleaning_robots_bench_" + std::to_string(::getpid());
+    const std::string textPath = base + ".txt";
+    const std::string indexPath = base + ".index.feed";
+    const std::string bitmapPath = base + ".bitmap.feed";
+    {
+        std::ofstream text(textPath);
+        text << feed.gridWidth << " " << feed.gridHeight << "\n";
+        for (const Position& p : feed.dirtSpots) {
+            text << p.x << " " << p.y << "\n";
+        }
+    }
+    std::cout << "  " << spec.width << "x" << spec.height << " floor, " << feed.dirtSpots.size() << " spots\n";
+
+    report("convert text -> index feed (Mspots)",
+           timeMs([&] { convertTextFeed(textPath, indexPath, FeedEncoding::CELL_INDEX32); }), spots);
+    writeFeedFile(bitmapPath, feed, FeedEncoding::BITMAP);
+
+    EnvironmentMap map;
+    report("text -> vector -> initializeGrid (Mspots)", timeMs([&] {
+        std::ifstream text(textPath);
+        int width = 0;
+        int height = 0;
+        text >> width >> height;
+        std::vector<Position> dirt;
+        Position p;
+        while (text >> p.x >> p.y) {
+            dirt.push_back(p);
+        }
+        map.initializeGrid(width, height, dirt);
+    }), spots);
+    report("in-memory vector -> initializeGrid (Mspots)",
+           timeMs([&] { map.initializeGrid(feed.gridWidth, feed.gridHeight, feed.dirtSpots); }), spots);
+    report("mmap index feed -> map (Mspots)",
+           timeMs([&] { FeedFile::open(indexPath).loadInto(map); }), spots);
+    report("mmap bitmap feed -> map (Mspots)",
+           timeMs([&] { FeedFile::open(bitmapPath).loadInto(map); }), spots);
+    g_benchSink = g_benchSink + map.countCells(CellState::DIRTY);
+
+    std::remove(textPath.c_str());
+    std::remove(indexPath.c_str());
+    std::remove(bitmapPath.c_str());
+}
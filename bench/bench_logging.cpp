@@ -0,0 +1,57 @@
+// bench_logging.cpp
+// Cost of one robot-action log line on the producing thread: iostream formatting (the previous
+// std::cout path) versus the asynchronous Log, both written to /dev/null, plus a filtered-out call.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "bench.hpp"
+#include "logging/log.hpp"
+
+namespace {
+constexpr int kLines = 500000;
+}
+
+void bench_logging() {
+    const std::string name = "v1";
+
+    std::ofstream sink("/dev/null");
+    const double streamMs = timeMs([&] {
+        for (int i = 0; i < kLines; ++i) {
+            sink << "[Vacuum#" << name << "] start moving toward (" << (i & 1023) << "," << (i >> 10) << ")\n";
+        }
+        sink.flush();
+    });
+    report("iostream", streamMs, kLines);
+
+    std::FILE* devNull = std::fopen("/dev/null", "w");
+    if (!devNull) {
+        return;
+    }
+    const LogLevel previous = Log::level();
+    Log::setLevel(LogLevel::DEBUG);
+    for (LogFormat format : {LogFormat::TEXT, LogFormat::BINARY}) {
+        Log::setOutput(devNull, format);
+        const double producerMs = timeMs([&] {
+            for (int i = 0; i < kLines; ++i) {
+                LOG_DEBUG("[Vacuum#", name, "] start moving toward (", i & 1023, ",", i >> 10, ")");
+            }
+        });
+        const double drainMs = timeMs([] { Log::flush(); });
+        report(std::string("Log ") + (format == LogFormat::TEXT ? "text" : "binary") + " (producer)", producerMs, kLines);
+        std::cout << "    writer backlog drained in " << drainMs << " ms\n";
+    }
+
+    Log::setLevel(LogLevel::WARN);
+    const double filteredMs = timeMs([&] {
+        for (int i = 0; i < kLines; ++i) {
+            LOG_DEBUG("[Vacuum#", name, "] start moving toward (", i & 1023, ",", i >> 10, ")");
+        }
+    });
+    report("Log below runtime level", filteredMs, kLines);
+
+    Log::setOutput(stdout);
+    Log::setLevel(previous);
+    std::fclose(devNull);
+}
@@ -0,0 +1,67 @@
+// bench_main.cpp
+// Entry point of the benchmark binary: runs every suite, or only the ones named on the command line.
+// Arguments of the form key=value are options for the suites (see benchOption).
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+struct BenchSuite {
+    const char* name;
+    void (*run)();
+};
+
+static const BenchSuite kSuites[] = {
+    {"environment_map", &bench_environment_map},
+    {"shm_transport", &bench_shm_transport},
+    {"logging", &bench_logging},
+    {"messages", &bench_messages},
+    {"nearest_idle", &bench_nearest_idle},
+    {"simulation", &bench_simulation},
+    {"cell_set", &bench_cell_set},
+    {"feed_file", &bench_feed_file},
+    {"checkpoint", &bench_checkpoint},
+    {"workload", &bench_workload},
+};
+
+static std::vector<std::string_view> g_suiteArgs;
+static std::vector<std::string_view> g_optionArgs;
+
+std::string_view benchOption(std::string_view key, std::string_view fallback) {
+    for (std::string_view arg : g_optionArgs) {
+        const std::size_t eq = arg.find('=');
+        if (arg.substr(0, eq) == key) {
+            return arg.substr(eq + 1);
+        }
+    }
+    return fallback;
+}
+
+double benchOption(std::string_view key, double fallback) {
+    const std::string_view value = benchOption(key);
+    return value.empty() ? fallback : std::strtod(std::string(value).c_str(), nullptr);
+}
+
+bool benchHasOptions() { return !g_optionArgs.empty(); }
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        (std::strchr(argv[i], '=') != nullptr ? g_optionArgs : g_suiteArgs).push_back(argv[i]);
+    }
+    for (const auto& suite : kSuites) {
+        bool selected = g_suiteArgs.empty();
+        for (std::string_view name : g_suiteArgs) {
+            selected = selected || name == suite.name;
+        }
+        if (!selected) {
+            continue;
+        }
+        std::cout << "\n=== bench: " << suite.name << " ===\n";
+        suite.run();
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+// bench_messages.cpp
+// Message text formatting: the previous ostringstream-based toString (kept here as a baseline)
+// versus the current toString and the allocation-free toChars.
+
+#include <sstream>
+#include <string>
+
+#include "bench.hpp"
+#include "messages/messages.hpp"
+
+namespace {
+
+constexpr int kMessages = 500000;
+
+std::string legacyPosStr(Position p) {
+    std::ostringstream os;
+    os << "(" << p.x << "," << p.y << ")";
+    return os.str();
+}
+
+std::string legacyToString(const WorkCompletedEvent& e) {
+    std::ostringstream os;
+    os << "[WorkCompletedEvent] from=" << e.from
+       << " kind=" << toString(e.workKind)
+       << " position=" << legacyPosStr(e.position)
+       << " ok=" << (e.success ? "true" : "false");
+    return os.str();
+}
+
+WorkCompletedEvent sample(int i) {
+    WorkCompletedEvent e;
+    e.from = i & 255;
+    e.workKind = WorkKind::VACUUM;
+    e.success = (i & 1) != 0;
+    e.position = {i & 4095, i >> 12};
+    return e;
+}
+
+}  // namespace
+
+void bench_messages() {
+    std::uint64_t chars = 0;
+    const double legacyMs = timeMs([&] {
+        for (int i = 0; i < kMessages; ++i) {
+            chars += legacyToString(sample(i)).size();
+        }
+    });
+    report("ostringstream toString (previous)", legacyMs, kMessages);
+
+    const double stringMs = timeMs([&] {
+        for (int i = 0; i < kMessages; ++i) {
+            chars += toString(sample(i)).size();
+        }
+    });
+    report("toString", stringMs, kMessages);
+
+    const double charsMs = timeMs([&] {
+        char buf[kMaxMessageText];
+        for (int i = 0; i < kMessages; ++i) {
+            chars += toChars(sample(i), buf, sizeof(buf));
+        }
+    });
+    report("toChars", charsMs, kMessages);
+    g_benchSink = g_benchSink + chars;
+}
@@ -0,0 +1,71 @@
+// bench_nearest_idle.cpp
+// Nearest-idle-robot lookups over FleetState-style columns: scalar versus SSE4.1 and AVX2 kernels
+// for fleets of 1k, 10k and 100k robots (a third of each type, about half of them idle).
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "registry/nearest_idle_kernel.hpp"
+
+namespace {
+
+struct Fleet {
+    std::vector<std::int32_t> xs, ys;
+    std::vector<RobotType> types;
+    std::vector<RobotState> states;
+
+    FleetColumns columns() const { return {xs.data(), ys.data(), types.data(), states.data(), xs.size()}; }
+};
+
+Fleet makeFleet(std::size_t n, std::mt19937& rng) {
+    std::uniform_int_distribution<int> coord(0, 4095);
+    std::uniform_int_distribution<int> pick(0, 5);
+    Fleet f;
+    for (std::size_t i = 0; i < n; ++i) {
+        f.xs.push_back(coord(rng));
+        f.ys.push_back(coord(rng));
+        f.types.push_back(static_cast<RobotType>(i % 3));
+        f.states.push_back(pick(rng) < 3 ? RobotState::IDLE : static_cast<RobotState>(1 + pick(rng) % 3));
+    }
+    return f;
+}
+
+}  // namespace
+
+void bench_nearest_idle() {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(0, 4095);
+    std::cout << "  best path on this CPU: " << kernelPathName(bestKernelPath()) << "\n";
+
+    for (std::size_t robots : {1000u, 10000u, 100000u}) {
+        const Fleet fleet = makeFleet(robots, rng);
+        const FleetColumns columns = fleet.columns();
+        const int queries = static_cast<int>(20000000 / robots);
+        std::vector<Position> targets;
+        for (int q = 0; q < queries; ++q) {
+            targets.push_back({coord(rng), coord(rng)});
+        }
+
+        std::vector<std::size_t> reference;
+        for (KernelPath path : {KernelPath::SCALAR, KernelPath::SSE41, KernelPath::AVX2}) {
+            if (path > bestKernelPath()) {
+                continue;
+            }
+            std::vector<std::size_t> found(targets.size());
+            const double ms = timeMs([&] {
+                for (std::size_t q = 0; q < targets.size(); ++q) {
+                    found[q] = nearestIdleSlot(columns, RobotType::WASHER, targets[q], path);
+                }
+            });
+            if (reference.empty()) {
+                reference = found;
+            }
+            report(std::to_string(robots) + " robots, " + kernelPathName(path)
+                       + (found == reference ? "" : " (MISMATCH)") + " lookups",
+                   ms, static_cast<double>(queries));
+            g_benchSink = g_benchSink + found.back();
+        }
+    }
+}
@@ -0,0 +1,134 @@
+// bench_shm_transport.cpp
+// Command -> event round trips through the in-process Bus versus a Bus whose robot lives in a
+// forked child process behind a ShmTransport: latency percentiles and pipelined messages/sec.
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "bench.hpp"
+#include "bus/bus.hpp"
+#include "bus/shm_robot_host.hpp"
+#include "bus/shm_transport.hpp"
+#include "robot/robot.hpp"
+
+namespace {
+
+constexpr int kRoundTrips = 20000;
+constexpr int kStreamed = 200000;
+
+// Answers every move with a status event and does nothing else, so only transport cost is measured.
+class EchoRobot : public RobotBase {
+public:
+    EchoRobot() : RobotBase("echo", RobotType::VACUUM) {}
+    void moveTo(Position dst) override { setPosition(dst); publishStatus(); }
+    void startWork(WorkKind kind) override { publishWorkCompleted(kind, true); }
+    void stop() override {}
+};
+
+void waitEvent(Bus& bus, Bus::EventVariant& event) {
+    while (!bus.poll(event)) {
+        std::this_thread::yield();   // the peer may share our core
+    }
+}
+
+void reportLatency(const std::string& name, std::vector<double>& samplesUs) {
+    std::sort(samplesUs.begin(), samplesUs.end());
+    auto pct = [&](double p) { return samplesUs[static_cast<std::size_t>(p * (samplesUs.size() - 1))]; };
+    std::cout << "  " << name << " round trip (us): p50 " << pct(0.50) << ", p90 " << pct(0.90)
+              << ", p99 " << pct(0.99) << ", p99.9 " << pct(0.999) << "\n";
+}
+
+// one command in flight at a time
+void measureRoundTrips(const std::string& name, Bus& bus, RobotId robot) {
+    std::vector<double> samplesUs;
+    samplesUs.reserve(kRoundTrips);
+    Bus::EventVariant event;
+    for (int i = 0; i < kRoundTrips; ++i) {
+        MoveCommand cmd;
+        cmd.to = robot;
+        cmd.position = {i & 1023, i >> 10};
+        const auto start = std::chrono::steady_clock::now();
+        bus.send(cmd);
+        waitEvent(bus, event);
+        const auto stop = std::chrono::steady_clock::now();
+        samplesUs.push_back(std::chrono::duration<double, std::micro>(stop - start).count());
+    }
+    reportLatency(name, samplesUs);
+}
+
+// keep sending and drain replies as they arrive
+void measureStream(const std::string& name, Bus& bus, RobotId robot) {
+    std::uint64_t received = 0;
+    const double ms = timeMs([&] {
+        Bus::EventVariant event;
+        for (int i = 0; i < kStreamed; ++i) {
+            MoveCommand cmd;
+            cmd.to = robot;
+            cmd.position = {i & 1023, i >> 10};
+            bus.send(cmd);
+            while (bus.poll(event)) {
+                ++received;
+            }
+        }
+        while (received < static_cast<std::uint64_t>(kStreamed)) {
+            waitEvent(bus, event);
+            ++received;
+        }
+    });
+    g_benchSink = g_benchSink + received;
+    report(name + " streamed moves", ms, kStreamed);
+}
+
+}  // namespace
+
+void bench_shm_transport() {
+    auto robot = std::make_shared<EchoRobot>();
+    RobotRegistry fleet;
+    fleet.add(robot);
+
+    {
+        Bus bus(fleet);
+        measureRoundTrips("in-process", bus, robot->id());
+        measureStream("in-process", bus, robot->id());
+    }
+
+    const std::string name = "/cleaning_robots_bench_" + std::to_string(::getpid());
+    ShmTransport transport = ShmTransport::create(name, 4096);
+    if (!transport.isOpen()) {
+        std::cout << "  shared memory unavailable, skipping cross-process case\n";
+        return;
+    }
+
+    const pid_t child = ::fork();
+    if (child == 0) {
+        // robot host: serve commands until the parent kills us
+        ShmTransport side = ShmTransport::open(name);
+        ShmRobotHost host(fleet, side);
+        for (;;) {
+            if (host.pump() == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    if (child < 0) {
+        std::cout << "  fork failed, skipping cross-process case\n";
+        return;
+    }
+
+    RobotRegistry local;   // the robot is not subscribed here, so commands go over shared memory
+    Bus bus(local);
+    bus.setRemote(&transport);
+    measureRoundTrips("shared-memory", bus, robot->id());
+    measureStream("shared-memory", bus, robot->id());
+    bus.setRemote(nullptr);
+
+    ::kill(child, SIGKILL);
+    ::waitpid(child, nullptr, 0);
+}
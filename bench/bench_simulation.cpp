@@ -0,0 +1,78 @@
+// bench_simulation.cpp
+// Wall time of a timed shift simulated with the fixed-step clock versus the event-driven one:
+// slow work relative to travel leaves most ticks without any state change.
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "control_unit/control_unit.hpp"
+#include "logging/log.hpp"
+#include "robot/detector_robot.hpp"
+#include "robot/vacuum_robot.hpp"
+#include "robot/washer_robot.hpp"
+
+namespace {
+
+constexpr int kGrid = 120;
+constexpr int kDetectors = 8;
+constexpr int kVacuums = 24;
+constexpr int kWashers = 12;
+
+SimulationStats simulateShift(SimulationMode mode, double& ms) {
+    RobotRegistry registry;
+    for (int i = 0; i < kDetectors; ++i) {
+        registry.add(std::make_shared<DetectorRobot>("d" + std::to_string(i), Position{0, 0}));
+    }
+    for (int i = 0; i < kVacuums; ++i) {
+        registry.add(std::make_shared<VacuumRobot>("v" + std::to_string(i), Position{i * 5 % kGrid, 0}));
+    }
+    for (int i = 0; i < kWashers; ++i) {
+        registry.add(std::make_shared<WasherRobot>("w" + std::to_string(i), Position{0, i * 10 % kGrid}));
+    }
+
+    std::mt19937 rng(11);
+    std::bernoulli_distribution dirty(0.03);
+    BootstrapFeed feed;
+    feed.gridWidth = kGrid;
+    feed.gridHeight = kGrid;
+    for (int y = 0; y < kGrid; ++y) {
+        for (int x = 0; x < kGrid; ++x) {
+            if (dirty(rng)) {
+                feed.dirtSpots.push_back({x, y});
+            }
+        }
+    }
+
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(feed);
+    cu.setSimulationMode(mode);
+    // one tick is a second: robots cover a cell per second, vacuuming takes 2 min, washing 5 min
+    cu.setRobotTiming(RobotType::DETECTOR, RobotTiming{1, 0});
+    cu.setRobotTiming(RobotType::VACUUM, RobotTiming{1, 120});
+    cu.setRobotTiming(RobotType::WASHER, RobotTiming{1, 300});
+    ms = timeMs([&] { cu.run(); });
+    return cu.simulationStats();
+}
+
+}  // namespace
+
+void bench_simulation() {
+    const LogLevel previous = Log::level();
+    Log::setLevel(LogLevel::WARN);
+
+    double steppedMs = 0.0;
+    double eventMs = 0.0;
+    const SimulationStats stepped = simulateShift(SimulationMode::TIME_STEPPED, steppedMs);
+    const SimulationStats events = simulateShift(SimulationMode::EVENT_DRIVEN, eventMs);
+    Log::setLevel(previous);
+
+    std::cout << "  " << kGrid << "x" << kGrid << " floor, " << (kDetectors + kVacuums + kWashers) << " robots, "
+              << stepped.tasksDispatched << " tasks, makespan " << stepped.makespan << " ticks"
+              << (stepped.makespan == events.makespan ? "" : " (event-driven MISMATCH)") << "\n";
+    report("time-stepped (ticks)", steppedMs, static_cast<double>(stepped.makespan));
+    report("event-driven (ticks)", eventMs, static_cast<double>(events.makespan));
+}
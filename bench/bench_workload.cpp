@@ -0,0 +1,99 @@
+// bench_workload.cpp
+// Headless ControlUnit::run on generated floors and fleets, to catch scaling regressions.
+// Without options it runs a 256x256 and a 1024x1024 preset; any key=value option switches to one
+// custom workload, e.g. `make bench BENCH_ARGS="workload grid=10000 density=0.001 storage=sparse"`.
+// Options: grid (or width/height), density, clustering, clusters, radius, detectors, vacuums,
+// washers, seed, storage (dense|sparse), policy (greedy|batch).
+
+#include <sys/resource.h>
+
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "control_unit/control_unit.hpp"
+#include "logging/log.hpp"
+#include "workload.hpp"
+
+namespace {
+
+double peakRssMb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;   // ru_maxrss is in KiB on Linux
+}
+
+WorkloadSpec specFromOptions() {
+    WorkloadSpec spec;
+    const int grid = static_cast<int>(benchOption("grid", 1024.0));
+    spec.width = static_cast<int>(benchOption("width", grid));
+    spec.height = static_cast<int>(benchOption("height", grid));
+    spec.density = benchOption("density", spec.density);
+    spec.clustering = benchOption("clustering", spec.clustering);
+    spec.clusters = static_cast<int>(benchOption("clusters", spec.clusters));
+    spec.clusterRadius = static_cast<int>(benchOption("radius", spec.clusterRadius));
+    spec.detectors = static_cast<std::size_t>(benchOption("detectors", static_cast<double>(spec.detectors)));
+    spec.vacuums = static_cast<std::size_t>(benchOption("vacuums", static_cast<double>(spec.vacuums)));
+    spec.washers = static_cast<std::size_t>(benchOption("washers", static_cast<double>(spec.washers)));
+    spec.seed = static_cast<unsigned>(benchOption("seed", spec.seed));
+    if (benchOption("storage") == "sparse") {
+        spec.storage = MapStorage::SPARSE;
+    }
+    return spec;
+}
+
+void runWorkload(const WorkloadSpec& spec, AssignmentPolicy policy) {
+    BootstrapFeed feed;
+    RobotRegistry registry;
+    EnvironmentMap map;
+    const double generateMs = timeMs([&] { feed = generateFeed(spec); });
+    // the control unit's bus subscribes the robots present when it is constructed
+    const double fleetMs = timeMs([&] { populateFleet(registry, spec); });
+    ControlUnit cu{registry, map};
+    cu.setAssignmentPolicy(policy);
+
+    const double seedMs = timeMs([&] { cu.seedFrom(feed); });
+    const std::size_t dirty = map.countCells(CellState::DIRTY);
+    const double runMs = timeMs([&] { cu.run(); });
+    std::size_t remaining = 0;
+    const double verifyMs = timeMs([&] {
+        remaining = map.countCells(CellState::DIRTY) + map.countCells(CellState::VACUUMED);
+    });
+
+    const double cells = static_cast<double>(map.cellCount());
+    const double tasks = 2.0 * static_cast<double>(dirty);   // every dirty cell is vacuumed, then washed
+    const double wallMs = generateMs + fleetMs + seedMs + runMs + verifyMs;
+    std::cout << "  " << spec.width << "x" << spec.height << ", " << dirty << " dirty cells ("
+              << spec.clustering * 100.0 << "% clustered), " << spec.detectors << "/" << spec.vacuums << "/"
+              << spec.washers << " robots, seed " << spec.seed
+              << (spec.storage == MapStorage::SPARSE ? ", sparse map" : "")
+              << (policy == AssignmentPolicy::BATCH ? ", batch policy" : "") << "\n";
+    std::cout << "    phases: generate " << generateMs << " ms | fleet " << fleetMs << " ms | seed " << seedMs
+              << " ms | run " << runMs << " ms | verify " << verifyMs << " ms\n";
+    std::cout << "    wall " << wallMs << " ms | " << (cells / runMs / 1000.0) << " Mcells/s | "
+              << (tasks / runMs) << " ktasks/s | peak RSS " << peakRssMb() << " MB | remaining dirt "
+              << remaining << (remaining == 0 ? "" : " (INCOMPLETE)") << "\n";
+}
+
+}  // namespace
+
+void bench_workload() {
+    const LogLevel previous = Log::level();
+    Log::setLevel(LogLevel::WARN);
+
+    const AssignmentPolicy policy =
+        benchOption("policy") == "batch" ? AssignmentPolicy::BATCH : AssignmentPolicy::GREEDY;
+    if (benchHasOptions()) {
+        runWorkload(specFromOptions(), policy);
+    } else {
+        for (int grid : {256, 1024}) {
+            WorkloadSpec spec;
+            spec.width = grid;
+            spec.height = grid;
+            runWorkload(spec, policy);
+        }
+    }
+
+    Log::flush();
+    Log::setLevel(previous);
+}
@@ -0,0 +1,66 @@
+// workload.cpp
+// Seeded generator of floors (uniform plus clustered dirt) and fleets for bench_workload.
+
+#include "workload.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "robot/detector_robot.hpp"
+#include "robot/vacuum_robot.hpp"
+#include "robot/washer_robot.hpp"
+
+BootstrapFeed generateFeed(const WorkloadSpec& spec) {
+    BootstrapFeed feed;
+    feed.gridWidth = spec.width;
+    feed.gridHeight = spec.height;
+    feed.storage = spec.storage;
+
+    const double cells = static_cast<double>(spec.width) * static_cast<double>(spec.height);
+    const auto total = static_cast<std::size_t>(std::clamp(spec.density, 0.0, 1.0) * cells);
+    const auto clustered = static_cast<std::size_t>(std::clamp(spec.clustering, 0.0, 1.0) * static_cast<double>(total));
+
+    std::mt19937_64 rng(spec.seed);
+    std::uniform_int_distribution<int> xs(0, spec.width - 1);
+    std::uniform_int_distribution<int> ys(0, spec.height - 1);
+    feed.dirtSpots.reserve(total);
+
+    std::vector<Position> centres;
+    for (int c = 0; c < spec.clusters; ++c) {
+        centres.push_back({xs(rng), ys(rng)});
+    }
+    if (!centres.empty()) {
+        std::uniform_int_distribution<std::size_t> pickCentre(0, centres.size() - 1);
+        std::normal_distribution<double> offset(0.0, static_cast<double>(spec.clusterRadius));
+        for (std::size_t i = 0; i < clustered; ++i) {
+            const Position c = centres[pickCentre(rng)];
+            const int x = std::clamp(c.x + static_cast<int>(std::lround(offset(rng))), 0, spec.width - 1);
+            const int y = std::clamp(c.y + static_cast<int>(std::lround(offset(rng))), 0, spec.height - 1);
+            feed.dirtSpots.push_back({x, y});
+        }
+    }
+    while (feed.dirtSpots.size() < total) {
+        feed.dirtSpots.push_back({xs(rng), ys(rng)});
+    }
+    return feed;
+}
+
+void populateFleet(RobotRegistry& registry, const WorkloadSpec& spec) {
+    std::mt19937_64 rng(spec.seed ^ 0x9e3779b97f4a7c15ULL);
+    std::uniform_int_distribution<int> xs(0, spec.width - 1);
+    std::uniform_int_distribution<int> ys(0, spec.height - 1);
+
+    for (std::size_t i = 0; i < spec.detectors; ++i) {
+        registry.add(std::make_shared<DetectorRobot>("Detector" + std::to_string(i), Position{xs(rng), ys(rng)}));
+    }
+    for (std::size_t i = 0; i < spec.vacuums; ++i) {
+        registry.add(std::make_shared<VacuumRobot>("Vacuum" + std::to_string(i), Position{xs(rng), ys(rng)}));
+    }
+    for (std::size_t i = 0; i < spec.washers; ++i) {
+        registry.add(std::make_shared<WasherRobot>("Washer" + std::to_string(i), Position{xs(rng), ys(rng)}));
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+
+#include "common/bootstrap.hpp"
+#include "registry/registry.hpp"
+
+// Synthetic floors and fleets for the scaling benchmarks.
+
+struct WorkloadSpec {
+    int width{1024};
+    int height{1024};
+    double density{0.01};        // share of the floor that starts dirty
+    double clustering{0.5};      // share of the dirt drawn around cluster centres, the rest is uniform
+    int clusters{32};            // number of cluster centres
+    int clusterRadius{24};       // standard deviation of a cluster, in cells
+    std::size_t detectors{4};
+    std::size_t vacuums{8};
+    std::size_t washers{8};
+    unsigned seed{1};
+    MapStorage storage{MapStorage::DENSE};
+};
+
+// Dirt spots for the spec (duplicates possible, so the floor may end up slightly cleaner than `density`).
+BootstrapFeed generateFeed(const WorkloadSpec& spec);
+// Adds the spec's robots to `registry` at seeded random positions on the floor.
+void populateFleet(RobotRegistry& registry, const WorkloadSpec& spec);
@@ -1,15 +1,81 @@
 #include "bus/bus.hpp"
 
+#include <chrono>
+#include <string_view>
+#include <thread>
+
+#include "bus/shm_transport.hpp"
+#include "logging/log.hpp"
 #include "robot/robot.hpp"
 
+namespace {
+
+// TRACE-level record of one message crossing the bus, formatted without allocating
+template<typename Message>
+void trace(const char* what, const Message& message) {
+    if (!LOG_ENABLED(LogLevel::TRACE)) {
+        return;
+    }
+    char text[kMaxMessageText];
+    const std::size_t length = toChars(message, text, sizeof(text));
+    LOG_TRACE("[Bus] ", what, " ", std::string_view(text, length));
+}
+
+}  // namespace
+
 // Initialize the bus with a reference to the robot registry, attach to all registered robots
-Bus::Bus(RobotRegistry& registry) : registry_(registry) {
-    auto robots = registry_.getAll();
-    for (const auto& robot : robots) {
-        if (robot) {
-            robot->attachBus(this);
-        }
+Bus::Bus(RobotRegistry& registry, std::size_t eventCapacity) : registry_(registry), events_(eventCapacity) {
+    for (RobotBase* robot : registry_.all()) {
+        attach(*robot);
+    }
+}
+
+Bus::Bus(RobotRegistry& registry, RobotType type, std::size_t eventCapacity)
+    : registry_(registry), events_(eventCapacity) {
+    for (RobotBase* robot : registry_.ofType(type)) {
+        attach(*robot);
+    }
+}
+
+void Bus::attach(RobotBase& robot) {
+    const RobotId id = robot.id();
+    if (id <= kBroadcastId) {
+        return;
+    }
+    const auto slot = static_cast<std::size_t>(id);
+    if (slot >= subscribers_.size()) {
+        subscribers_.resize(slot + 1, nullptr);
+    }
+    subscribers_[slot] = &robot;
+    robot.attachBus(this);
+}
+
+void Bus::detach(RobotId id) {
+    if (id <= kBroadcastId || static_cast<std::size_t>(id) >= subscribers_.size()) {
+        return;
     }
+    if (RobotBase*& robot = subscribers_[static_cast<std::size_t>(id)]) {
+        robot->attachBus(nullptr);
+        robot = nullptr;
+    }
+}
+
+/////////// directed delivery - called by the control unit to command a single robot
+
+void Bus::send(MoveCommand cmd) {
+    sendImpl(cmd);
+}
+
+void Bus::send(StartWorkCommand cmd) {
+    sendImpl(cmd);
+}
+
+void Bus::send(StopCommand cmd) {
+    sendImpl(cmd);
+}
+
+void Bus::send(TickCommand cmd) {
+    sendImpl(cmd);
 }
 
 /////////// command broadcasting - called by the control unit to direct robot actions
@@ -26,6 +92,10 @@ void Bus::broadcast(StopCommand cmd) {
     broadcastImpl(cmd);
 }
 
+void Bus::broadcast(TickCommand cmd) {
+    broadcastImpl(cmd);
+}
+
 /////////// event publishing - called by robots to report happenings
 
 void Bus::publish(DetectionEvent event) {
@@ -42,34 +112,164 @@ void Bus::publish(WorkCompletedEvent event) {
 
 
 bool Bus::poll(EventVariant& out) {     // out is reference, fill it with next event only if any
-    if (events_.empty()) {
-        return false;
+    consumer_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    if (events_.tryPop(out)) {
+        return true;
+    }
+    if (overflowSize_.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(overflowMutex_);
+        if (!overflow_.empty()) {
+            out = std::move(overflow_.front());
+            overflow_.pop_front();
+            overflowSize_.store(overflow_.size(), std::memory_order_release);
+            return true;
+        }
+    }
+    return remote_ && remote_->pollEvent(out);
+}
+
+std::size_t Bus::pollBatch(std::vector<EventVariant>& out, std::size_t max) {
+    consumer_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    out.clear();
+    std::size_t taken = events_.tryPopBatch(out, max);
+    if (taken < max && overflowSize_.load(std::memory_order_acquire) > 0) {
+        taken += takeOverflow(out, max - taken);
+    }
+    if (remote_) {
+        EventVariant event;
+        while (taken < max && remote_->pollEvent(event)) {
+            out.push_back(event);
+            ++taken;
+        }
+    }
+    return taken;
+}
+
+Bus::EventStats Bus::eventStats() const {
+    EventStats stats;
+    stats.published = published_.load(std::memory_order_relaxed);
+    stats.fullWaits = fullWaits_.load(std::memory_order_relaxed);
+    stats.spilled = spilled_.load(std::memory_order_relaxed);
+    stats.highWater = highWater_.load(std::memory_order_relaxed);
+    stats.capacity = events_.capacity();
+    return stats;
+}
+
+template<typename Command>
+void Bus::sendImpl(Command& cmd) { // deliver to the addressed robot only
+    if (cmd.to == kBroadcastId) {
+        broadcastImpl(cmd);
+        return;
+    }
+    trace("send", cmd);
+    RobotBase* robot = nullptr;
+    if (cmd.to > kBroadcastId && static_cast<std::size_t>(cmd.to) < subscribers_.size()) {
+        robot = subscribers_[static_cast<std::size_t>(cmd.to)];
+    }
+    if (robot) {
+        robot->handle(cmd);
+    } else if (remote_) {
+        forwardRemote(cmd);
     }
-    out = std::move(events_.front());
-    events_.pop();
-    return true;
 }
 
 template<typename Command>  
 void Bus::broadcastImpl(Command& cmd) { // send command to all robots, let them decide if relevant
-    auto robots = registry_.getAll();
-    for (const auto& robot : robots) {
+    trace("broadcast", cmd);
+    for (RobotBase* robot : subscribers_) {
         if (robot) {
             robot->handle(cmd);
         }
     }
+    if (remote_) {
+        forwardRemote(cmd);
+    }
+}
+
+template<typename Command>
+void Bus::forwardRemote(const Command& cmd) { // hand the command to the other process, waiting while its ring is full
+    std::lock_guard<std::mutex> lock(remoteMutex_);
+    if (remote_->sendCommand(cmd)) {
+        return;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + kRemoteSendTimeout;
+    while (!remote_->sendCommand(cmd)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            remoteDropped_.fetch_add(1, std::memory_order_relaxed);
+            char text[kMaxMessageText];
+            const std::size_t length = toChars(cmd, text, sizeof(text));
+            LOG_ERROR("[Bus] remote host is not reading commands, dropped ", std::string_view(text, length));
+            return;
+        }
+        std::this_thread::yield();
+    }
 }
 
 template<typename Event>
-void Bus::publishImpl(Event& event) { // add event to the queue for later processing by the CU
-    events_.push(event);
+void Bus::publishImpl(Event& event) { // add event to the ring for later processing by the CU
+    trace("publish", event);
+    EventVariant item{std::move(event)};
+    if (overflowSize_.load(std::memory_order_acquire) > 0) {
+        spill(std::move(item));   // earlier events are still waiting in the overflow list
+    } else if (!events_.tryPush(std::move(item))) {
+        fullWaits_.fetch_add(1, std::memory_order_relaxed);
+        const std::thread::id consumer = consumer_.load(std::memory_order_relaxed);
+        if (consumer == std::thread::id{} || consumer == std::this_thread::get_id()) {
+            // nobody else will drain the ring while this thread is publishing: waiting would deadlock
+            spill(std::move(item));
+        } else {
+            // ring full: wait for the consumer to make room
+            while (!events_.tryPush(std::move(item))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    published_.fetch_add(1, std::memory_order_relaxed);
+    noteDepth();
+}
+
+void Bus::spill(EventVariant&& item) {
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    overflow_.push_back(std::move(item));
+    overflowSize_.store(overflow_.size(), std::memory_order_release);
+    spilled_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t Bus::takeOverflow(std::vector<EventVariant>& out, std::size_t max) {
+    std::lock_guard<std::mutex> lock(overflowMutex_);
+    std::size_t taken = 0;
+    while (taken < max && !overflow_.empty()) {
+        out.push_back(std::move(overflow_.front()));
+        overflow_.pop_front();
+        ++taken;
+    }
+    overflowSize_.store(overflow_.size(), std::memory_order_release);
+    return taken;
+}
+
+void Bus::noteDepth() { // track the high-water mark of the ring occupancy
+    const std::size_t depth = events_.sizeApprox();
+    std::size_t seen = highWater_.load(std::memory_order_relaxed);
+    while (depth > seen && !highWater_.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {
+    }
 }
 
 // Force template code generation for these types in this .cpp file
 // (avoids duplicate instantiations across translation units)
+template void Bus::sendImpl(MoveCommand& cmd);
+template void Bus::sendImpl(StartWorkCommand& cmd);
+template void Bus::sendImpl(StopCommand& cmd);
+template void Bus::sendImpl(TickCommand& cmd);
+
 template void Bus::broadcastImpl(MoveCommand& cmd);
 template void Bus::broadcastImpl(StartWorkCommand& cmd);
 template void Bus::broadcastImpl(StopCommand& cmd);
+template void Bus::broadcastImpl(TickCommand& cmd);
+
+template void Bus::forwardRemote(const MoveCommand& cmd);
+template void Bus::forwardRemote(const StartWorkCommand& cmd);
+template void Bus::forwardRemote(const StopCommand& cmd);
+template void Bus::forwardRemote(const TickCommand& cmd);
 
 template void Bus::publishImpl(DetectionEvent& event);
 template void Bus::publishImpl(StatusEvent& event);
@@ -1,40 +1,124 @@
 #pragma once
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <variant>
 #include <vector>
 
+#include "bus/event_ring.hpp"
 #include "messages/messages.hpp"
 #include "registry/registry.hpp"
 
+class ShmTransport;
+
 // In-process message bus that routes commands to robots and buffers their events.
 class Bus {
 public:
     using EventVariant = std::variant<DetectionEvent, StatusEvent, WorkCompletedEvent>;
 
-    Bus(RobotRegistry& registry);
+    static constexpr std::size_t kDefaultEventCapacity = 1u << 16;
+    // how long a command waits for room in the remote command ring before it is dropped
+    static constexpr std::chrono::milliseconds kRemoteSendTimeout{1000};
+
+    // backpressure statistics of the event ring
+    struct EventStats {
+        std::uint64_t published{0};  // events accepted into the ring
+        std::uint64_t fullWaits{0};  // publish attempts that found the ring full
+        std::uint64_t spilled{0};    // events parked in the overflow list instead of waiting
+        std::size_t   highWater{0};  // deepest observed ring occupancy
+        std::size_t   capacity{0};
+    };
+
+    Bus(RobotRegistry& registry, std::size_t eventCapacity = kDefaultEventCapacity);
+    // bus that only subscribes the robots of one type (e.g. the event channel of a pipeline stage)
+    Bus(RobotRegistry& registry, RobotType type, std::size_t eventCapacity = kDefaultEventCapacity);
 
-    // command broadcasting - called by the control unit to direct robot actions
+    // subscribe a robot for directed delivery (done for every registered robot on construction)
+    void attach(RobotBase& robot);
+    // unsubscribe a robot (e.g. before removing it from the registry)
+    void detach(RobotId id);
+
+    // directed delivery - resolves cmd.to in the subscriber table and delivers in O(1)
+    void send(MoveCommand cmd);
+    void send(StartWorkCommand cmd);
+    void send(StopCommand cmd);
+    void send(TickCommand cmd);
+
+    // command broadcasting - fan-out to every subscribed robot (use kBroadcastId to address all)
     void broadcast(MoveCommand cmd);        
     void broadcast(StartWorkCommand cmd);   
     void broadcast(StopCommand cmd);        
+    void broadcast(TickCommand cmd);
 
-    // event publishing - called by robots to report happenings
+    // event publishing - called by robots to report happenings, safe from any thread.
+    // When the ring is full another thread waits for the consumer to drain it; the consuming thread
+    // itself (a robot handling a command sent from the drain loop) cannot, so its events spill into
+    // an overflow list that poll()/pollBatch() hand out after the ring.
     void publish(DetectionEvent event);     
     void publish(StatusEvent event);
     void publish(WorkCompletedEvent event);
 
-    // event retrieval - called by the control unit to process robot reports
+    // event retrieval - called by the control unit (single consumer) to process robot reports
     bool poll(EventVariant& out);
+    // batched retrieval - replaces the contents of `out` with up to `max` events (in publish order),
+    // returns how many were taken
+    std::size_t pollBatch(std::vector<EventVariant>& out, std::size_t max);
+
+    EventStats eventStats() const;
+    std::size_t eventCapacity() const { return events_.capacity(); }
+
+    // route commands for robots that are not subscribed here over `transport` (robots hosted in
+    // another process) and merge the events coming back from it into poll()/pollBatch();
+    // nullptr detaches. The transport must outlive the bus or be detached first, and must not be
+    // swapped while commands are being sent. Its command ring has a single producer, so senders on
+    // different threads (pipeline stages) take turns on a mutex. A command that finds no room within
+    // kRemoteSendTimeout (the host died or stopped reading) is dropped and logged as an error.
+    void setRemote(ShmTransport* transport) { remote_ = transport; }
+    // commands dropped because the remote host did not make room in time
+    std::uint64_t remoteDropped() const { return remoteDropped_.load(std::memory_order_relaxed); }
 
 private:
     template<typename Command>
-    // fan-out helper that forwards the command to all registered robots
+    // unicast helper that looks the recipient up by id and forwards the command
+    void sendImpl(Command& cmd);
+
+    template<typename Command>
+    // fan-out helper that forwards the command to all subscribed robots
     void broadcastImpl(Command& cmd);
 
+    template<typename Command>
+    // pass a command on to the remote transport, giving up after kRemoteSendTimeout
+    void forwardRemote(const Command& cmd);
+
     template<typename Event>
     // enqueue the event for later retrieval via poll()
     void publishImpl(Event& event);
+    // park an event behind the ring, keeping publish order
+    void spill(EventVariant&& item);
+    // move up to `max` overflow events to `out`, returns how many
+    std::size_t takeOverflow(std::vector<EventVariant>& out, std::size_t max);
+    void noteDepth();
 
     RobotRegistry& registry_;
-    std::queue<EventVariant> events_;
+    // dense id-indexed subscriber table: subscribers_[id] is the robot with that id, or nullptr
+    std::vector<RobotBase*> subscribers_;
+    EventRing<EventVariant> events_;
+    ShmTransport* remote_{nullptr};
+    std::mutex    remoteMutex_;   // serializes producers of the remote command ring
+    std::atomic<std::uint64_t> remoteDropped_{0};
+    // overflow behind the ring; while it is non-empty every publish goes here so that order holds
+    std::mutex               overflowMutex_;
+    std::deque<EventVariant> overflow_;
+    std::atomic<std::size_t> overflowSize_{0};
+    // thread that last polled (the consumer); default-constructed until the first poll
+    std::atomic<std::thread::id> consumer_{};
+
+    std::atomic<std::uint64_t> published_{0};
+    std::atomic<std::uint64_t> fullWaits_{0};
+    std::atomic<std::uint64_t> spilled_{0};
+    std::atomic<std::size_t>   highWater_{0};
 };
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free multi-producer / single-consumer ring buffer.
+// Producers claim a position with one CAS on head_ once the consumer has freed it (head_ - tail_ below
+// capacity), write the value and stamp the slot's sequence number with position + 1 to mark it
+// ready. The consumer never locks: it reads ready slots in order and frees them by advancing tail_,
+// so a batch of any size is handed back to the producers with a single store.
+template<typename T>
+class EventRing {
+public:
+    // capacity is rounded up to the next power of two (minimum 2)
+    explicit EventRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_.reset(new Slot[size]);
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    // producers - safe from any number of threads; false if the ring is full
+    bool tryPush(T&& value) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            // signed: a stale `pos` may already lie behind the tail
+            const auto used = static_cast<std::ptrdiff_t>(pos - tail_.load(std::memory_order_acquire));
+            if (used >= static_cast<std::ptrdiff_t>(mask_ + 1)) {
+                return false;   // consumer has not freed this slot yet
+            }
+            if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                Slot& slot = slots_[pos & mask_];
+                slot.value = std::move(value);
+                slot.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    // consumer - must only be called from one thread at a time; false if the ring is empty
+    bool tryPop(T& out) {
+        const std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        out = std::move(slot.value);
+        tail_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer - moves up to `max` consecutive ready items into `out` (appended), returns the count.
+    // The ready run is found first, moved out in one pass and freed with one tail_ advance.
+    std::size_t tryPopBatch(std::vector<T>& out, std::size_t max) {
+        const std::size_t start = tail_.load(std::memory_order_relaxed);
+        const std::size_t claimed = head_.load(std::memory_order_acquire) - start;
+        const std::size_t limit = claimed < max ? claimed : max;
+        std::size_t ready = 0;
+        while (ready < limit && slots_[(start + ready) & mask_].seq.load(std::memory_order_acquire) == start + ready + 1) {
+            ++ready;
+        }
+        if (ready == 0) {
+            return 0;
+        }
+        out.reserve(out.size() + ready);
+        for (std::size_t i = 0; i < ready; ++i) {
+            out.push_back(std::move(slots_[(start + i) & mask_].value));
+        }
+        tail_.store(start + ready, std::memory_order_release);
+        return ready;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // approximate number of queued items (exact when called from the consumer with no producers active)
+    std::size_t sizeApprox() const {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq{0};   // position + 1 once the value at that position is written
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};   // next slot producers will claim
+    alignas(64) std::atomic<std::size_t> tail_{0};   // next slot the consumer will read
+};
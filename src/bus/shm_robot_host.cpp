@@ -0,0 +1,30 @@
+#include "bus/shm_robot_host.hpp"
+
+#include <thread>
+#include <variant>
+
+ShmRobotHost::ShmRobotHost(RobotRegistry& registry, ShmTransport& transport)
+    : transport_(transport), local_(registry) {
+}
+
+std::size_t ShmRobotHost::pump(std::size_t max) {
+    std::size_t handled = 0;
+    ShmTransport::CommandVariant cmd;
+    while (handled < max && transport_.pollCommand(cmd)) {
+        std::visit([this](const auto& c) { local_.send(c); }, cmd);
+        ++handled;
+        forwardEvents();
+    }
+    return handled;
+}
+
+void ShmRobotHost::forwardEvents() {
+    Bus::EventVariant event;
+    while (local_.poll(event)) {
+        std::visit([this](const auto& e) {
+            while (!transport_.publishEvent(e)) {
+                std::this_thread::yield();
+            }
+        }, event);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+#include "bus/bus.hpp"
+#include "bus/shm_transport.hpp"
+
+// Robot-side end of a ShmTransport: hosts the robots of a registry in this process, delivers the
+// commands arriving from the control unit through a local Bus and forwards the robots' events back.
+class ShmRobotHost {
+public:
+    ShmRobotHost(RobotRegistry& registry, ShmTransport& transport);
+
+    // handle up to `max` pending commands and forward every event they produced;
+    // returns the number of commands handled (0 means the command ring was empty)
+    std::size_t pump(std::size_t max = 256);
+
+private:
+    void forwardEvents();
+
+    ShmTransport& transport_;
+    Bus           local_;
+};
@@ -0,0 +1,268 @@
+#include "bus/shm_transport.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The rings live in memory shared between processes, so their indices must be address-free atomics.
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared-memory rings need lock-free 64-bit atomics");
+
+namespace {
+constexpr std::uint32_t kSegmentMagic = 0x43524253;   // "CRBS"
+constexpr std::uint32_t kSegmentVersion = 1;
+}
+
+// SPSC ring: the producer owns head, the consumer owns tail; slots follow the header.
+struct ShmTransport::Ring {
+    std::uint64_t capacity;   // power of two
+    alignas(64) std::atomic<std::uint64_t> head;   // next slot to write
+    alignas(64) std::atomic<std::uint64_t> tail;   // next slot to read
+    std::uint64_t slotsOffset;                      // from the start of the segment
+};
+
+struct ShmTransport::Segment {
+    std::uint32_t magic;
+    std::uint32_t version;
+    Ring commands;   // control unit -> robot host
+    Ring events;     // robot host -> control unit
+
+    std::uint8_t* slots(const Ring& ring) {
+        return reinterpret_cast<std::uint8_t*>(this) + ring.slotsOffset;
+    }
+};
+
+ShmTransport ShmTransport::create(const std::string& name, std::size_t capacity) {
+    std::uint64_t slots = 2;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+    const std::size_t ringBytes = slots * kMaxWireSize;
+    const std::size_t total = sizeof(Segment) + 2 * ringBytes;
+
+    ShmTransport transport;
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return transport;
+    }
+    void* mem = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(total)) == 0) {
+        mem = ::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        return transport;
+    }
+
+    // placement-construct the header; the fresh mapping is zero-filled
+    auto* segment = new (mem) Segment{};
+    segment->commands.capacity = slots;
+    segment->commands.slotsOffset = sizeof(Segment);
+    segment->events.capacity = slots;
+    segment->events.slotsOffset = sizeof(Segment) + ringBytes;
+    segment->version = kSegmentVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    segment->magic = kSegmentMagic;
+
+    transport.name_ = name;
+    transport.segment_ = segment;
+    transport.mappedBytes_ = total;
+    transport.owner_ = true;
+    return transport;
+}
+
+ShmTransport ShmTransport::open(const std::string& name) {
+    ShmTransport transport;
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return transport;
+    }
+    struct stat st {};
+    void* mem = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= sizeof(Segment)) {
+        mem = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        return transport;
+    }
+    auto* segment = static_cast<Segment*>(mem);
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    // the header comes from another process: both rings must fit in the mapping (checked without
+    // overflow) and wrap with a mask, or push/pop would index outside it
+    auto ringFits = [size](const Ring& ring) {
+        const std::uint64_t capacity = ring.capacity;
+        const std::uint64_t offset = ring.slotsOffset;
+        return capacity != 0 && (capacity & (capacity - 1)) == 0
+            && offset >= sizeof(Segment) && offset <= size
+            && capacity <= (size - offset) / kMaxWireSize;
+    };
+    if (segment->magic != kSegmentMagic || segment->version != kSegmentVersion) {
+        ::munmap(mem, size);
+        return transport;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!ringFits(segment->commands) || !ringFits(segment->events)) {
+        ::munmap(mem, size);
+        return transport;
+    }
+
+    transport.name_ = name;
+    transport.segment_ = segment;
+    transport.mappedBytes_ = size;
+    return transport;
+}
+
+ShmTransport::ShmTransport(ShmTransport&& other) noexcept
+    : name_(std::move(other.name_)), segment_(other.segment_), mappedBytes_(other.mappedBytes_), owner_(other.owner_) {
+    other.segment_ = nullptr;
+    other.owner_ = false;
+}
+
+ShmTransport& ShmTransport::operator=(ShmTransport&& other) noexcept {
+    if (this != &other) {
+        release();
+        name_ = std::move(other.name_);
+        segment_ = other.segment_;
+        mappedBytes_ = other.mappedBytes_;
+        owner_ = other.owner_;
+        other.segment_ = nullptr;
+        other.owner_ = false;
+    }
+    return *this;
+}
+
+ShmTransport::~ShmTransport() {
+    release();
+}
+
+void ShmTransport::release() {
+    if (segment_) {
+        ::munmap(segment_, mappedBytes_);
+        segment_ = nullptr;
+    }
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+        owner_ = false;
+    }
+}
+
+/////////// ring primitives
+
+bool ShmTransport::push(Ring& ring, std::uint8_t* slots, const std::uint8_t* frame, std::size_t size) {
+    const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= ring.capacity) {
+        return false;
+    }
+    std::uint8_t* slot = slots + (head & (ring.capacity - 1)) * kMaxWireSize;
+    std::memcpy(slot, frame, size);
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool ShmTransport::pop(Ring& ring, const std::uint8_t* slots, std::uint8_t* frame) {
+    const std::uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    if (tail == ring.head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::memcpy(frame, slots + (tail & (ring.capacity - 1)) * kMaxWireSize, kMaxWireSize);
+    ring.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename Message>
+bool ShmTransport::pushMessage(Ring& ring, const Message& message) {
+    if (!segment_) {
+        return false;
+    }
+    std::uint8_t frame[kMaxWireSize];
+    const std::size_t size = encode(message, frame);
+    return push(ring, segment_->slots(ring), frame, size);
+}
+
+/////////// control-unit side
+
+bool ShmTransport::sendCommand(const MoveCommand& cmd)      { return pushMessage(segment_->commands, cmd); }
+bool ShmTransport::sendCommand(const StartWorkCommand& cmd) { return pushMessage(segment_->commands, cmd); }
+bool ShmTransport::sendCommand(const StopCommand& cmd)      { return pushMessage(segment_->commands, cmd); }
+bool ShmTransport::sendCommand(const TickCommand& cmd)      { return pushMessage(segment_->commands, cmd); }
+
+bool ShmTransport::pollEvent(EventVariant& out) {
+    if (!segment_) {
+        return false;
+    }
+    std::uint8_t frame[kMaxWireSize];
+    // a frame that fails to decode is dropped; keep draining
+    while (pop(segment_->events, segment_->slots(segment_->events), frame)) {
+        MessageTag tag;
+        if (!peekTag(frame, kMaxWireSize, tag)) {
+            continue;
+        }
+        switch (tag) {
+            case MessageTag::DETECTION: {
+                DetectionEvent e;
+                if (decode(frame, kMaxWireSize, e)) { out = e; return true; }
+                break;
+            }
+            case MessageTag::STATUS: {
+                StatusEvent e;
+                if (decode(frame, kMaxWireSize, e)) { out = e; return true; }
+                break;
+            }
+            case MessageTag::WORK_COMPLETED: {
+                WorkCompletedEvent e;
+                if (decode(frame, kMaxWireSize, e)) { out = e; return true; }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+/////////// robot-host side
+
+bool ShmTransport::publishEvent(const DetectionEvent& event)     { return pushMessage(segment_->events, event); }
+bool ShmTransport::publishEvent(const StatusEvent& event)        { return pushMessage(segment_->events, event); }
+bool ShmTransport::publishEvent(const WorkCompletedEvent& event) { return pushMessage(segment_->events, event); }
+
+bool ShmTransport::pollCommand(CommandVariant& out) {
+    if (!segment_) {
+        return false;
+    }
+    std::uint8_t frame[kMaxWireSize];
+    while (pop(segment_->commands, segment_->slots(segment_->commands), frame)) {
+        MessageTag tag;
+        if (!peekTag(frame, kMaxWireSize, tag)) {
+            continue;
+        }
+        switch (tag) {
+            case MessageTag::MOVE: {
+                MoveCommand c;
+                if (decode(frame, kMaxWireSize, c)) { out = c; return true; }
+                break;
+            }
+            case MessageTag::START_WORK: {
+                StartWorkCommand c;
+                if (decode(frame, kMaxWireSize, c)) { out = c; return true; }
+                break;
+            }
+            case MessageTag::STOP: {
+                StopCommand c;
+                if (decode(frame, kMaxWireSize, c)) { out = c; return true; }
+                break;
+            }
+            case MessageTag::TICK: {
+                TickCommand c;
+                if (decode(frame, kMaxWireSize, c)) { out = c; return true; }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return false;
+}
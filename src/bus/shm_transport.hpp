@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+
+#include "messages/messages.hpp"
+
+// Cross-process transport for bus traffic over POSIX shared memory.
+//
+// One segment holds two single-producer/single-consumer rings of fixed kMaxWireSize slots:
+// commands flow down (control unit -> robot host) and events flow up (robot host -> control unit).
+// Messages travel in the binary wire format from messages.hpp, so both processes only need to
+// agree on that encoding, not on struct layout.
+class ShmTransport {
+public:
+    using CommandVariant = std::variant<MoveCommand, StartWorkCommand, StopCommand, TickCommand>;
+    using EventVariant = std::variant<DetectionEvent, StatusEvent, WorkCompletedEvent>;
+
+    // create and own a new segment (the name is unlinked again on destruction); capacity is per
+    // direction and rounded up to a power of two. Check isOpen() for failure.
+    static ShmTransport create(const std::string& name, std::size_t capacity);
+    // map an existing segment created by another process; fails if its header does not describe
+    // two power-of-two rings that fit inside the segment
+    static ShmTransport open(const std::string& name);
+
+    ShmTransport() = default;
+    ShmTransport(ShmTransport&& other) noexcept;
+    ShmTransport& operator=(ShmTransport&& other) noexcept;
+    ShmTransport(const ShmTransport&) = delete;
+    ShmTransport& operator=(const ShmTransport&) = delete;
+    ~ShmTransport();
+
+    bool isOpen() const { return segment_ != nullptr; }
+    const std::string& name() const { return name_; }
+
+    // control-unit side: false if the command ring is full
+    bool sendCommand(const MoveCommand& cmd);
+    bool sendCommand(const StartWorkCommand& cmd);
+    bool sendCommand(const StopCommand& cmd);
+    bool sendCommand(const TickCommand& cmd);
+    bool pollEvent(EventVariant& out);
+
+    // robot-host side: false if the event ring is full
+    bool publishEvent(const DetectionEvent& event);
+    bool publishEvent(const StatusEvent& event);
+    bool publishEvent(const WorkCompletedEvent& event);
+    bool pollCommand(CommandVariant& out);
+
+private:
+    struct Ring;
+    struct Segment;
+
+    static bool push(Ring& ring, std::uint8_t* slots, const std::uint8_t* frame, std::size_t size);
+    static bool pop(Ring& ring, const std::uint8_t* slots, std::uint8_t* frame);
+    template<typename Message>
+    bool pushMessage(Ring& ring, const Message& message);
+
+    void release();
+
+    std::string name_;
+    Segment*    segment_{nullptr};
+    std::size_t mappedBytes_{0};
+    bool        owner_{false};
+};
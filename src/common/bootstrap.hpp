@@ -1,10 +1,15 @@
 #pragma once
+#include <string>
 #include <vector>
 #include "robot/robot.hpp"
+#include "environment/environment_map.hpp"
 
 struct BootstrapFeed {
     int gridWidth{0};
     int gridHeight{0};
     std::vector<Position> dirtSpots;
+    MapStorage storage{MapStorage::DENSE};   // SPARSE for huge, mostly-clean floors
+    // coverage patterns handed to detectors round-robin (see PatternRegistry for the names)
+    std::vector<std::string> scanPatterns{"serpentine"};
 };
     
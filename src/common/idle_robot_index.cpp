@@ -0,0 +1,136 @@
+#include "common/idle_robot_index.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void IdleRobotIndex::clear() {
+    buckets_.clear();
+    where_.clear();
+    minBx_ = minBy_ = 0;
+    maxBx_ = maxBy_ = -1;
+}
+
+void IdleRobotIndex::insert(RobotId id, Position pos) {
+    remove(id);
+    const int bx = bucketOf(pos.x);
+    const int by = bucketOf(pos.y);
+    buckets_[keyOf(bx, by)].push_back(Entry{id, pos});
+    where_[id] = pos;
+
+    if (maxBx_ < minBx_) {   // first bucket since clear()
+        minBx_ = maxBx_ = bx;
+        minBy_ = maxBy_ = by;
+    } else {
+        minBx_ = std::min(minBx_, bx);
+        maxBx_ = std::max(maxBx_, bx);
+        minBy_ = std::min(minBy_, by);
+        maxBy_ = std::max(maxBy_, by);
+    }
+}
+
+void IdleRobotIndex::remove(RobotId id) {
+    auto it = where_.find(id);
+    if (it == where_.end()) {
+        return;
+    }
+    auto bucketIt = buckets_.find(keyOf(bucketOf(it->second.x), bucketOf(it->second.y)));
+    if (bucketIt != buckets_.end()) {
+        auto& entries = bucketIt->second;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].id == id) {
+                entries[i] = entries.back();
+                entries.pop_back();
+                break;
+            }
+        }
+        if (entries.empty()) {
+            buckets_.erase(bucketIt);
+        }
+    }
+    where_.erase(it);
+}
+
+bool IdleRobotIndex::nearest(Position target, RobotId& out) const {
+    switch (findNearby(target, out)) {
+        case Lookup::FOUND:      return true;
+        case Lookup::EMPTY:      return false;
+        case Lookup::TOO_SPARSE: break;
+    }
+    return nearestByScan(target, out);
+}
+
+IdleRobotIndex::Lookup IdleRobotIndex::findNearby(Position target, RobotId& out) const {
+    if (where_.empty()) {
+        return Lookup::EMPTY;
+    }
+    // a probe costs about as much as looking at one robot: past this, a linear pass is cheaper
+    const std::size_t maxProbes = std::max<std::size_t>(where_.size(), 9);
+    std::size_t probes = 0;
+    const int tbx = bucketOf(target.x);
+    const int tby = bucketOf(target.y);
+    // farthest ring that can still contain an indexed bucket
+    const int maxRing = std::max({tbx - minBx_, maxBx_ - tbx, tby - minBy_, maxBy_ - tby, 0});
+
+    int bestDistance = std::numeric_limits<int>::max();
+    RobotId bestId = 0;
+    auto scanBucket = [&](int bx, int by) {
+        auto it = buckets_.find(keyOf(bx, by));
+        if (it == buckets_.end()) {
+            return;
+        }
+        for (const auto& entry : it->second) {
+            const int dist = manhattan(entry.pos, target);
+            if (dist < bestDistance || (dist == bestDistance && entry.id < bestId)) {
+                bestDistance = dist;
+                bestId = entry.id;
+            }
+        }
+    };
+
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        probes += ring == 0 ? 1 : 8 * static_cast<std::size_t>(ring);
+        if (probes > maxProbes) {
+            return Lookup::TOO_SPARSE;
+        }
+        // buckets at Chebyshev distance `ring` from the target bucket
+        for (int dx = -ring; dx <= ring; ++dx) {
+            scanBucket(tbx + dx, tby - ring);
+            if (ring > 0) {
+                scanBucket(tbx + dx, tby + ring);
+            }
+        }
+        for (int dy = -ring + 1; dy <= ring - 1; ++dy) {
+            scanBucket(tbx - ring, tby + dy);
+            scanBucket(tbx + ring, tby + dy);
+        }
+        // every robot in ring+1 or beyond is at least ring*bucketSize+1 away;
+        // strict '<' keeps scanning when a farther ring could still win a tie on id
+        if (bestDistance < ring * bucketSize_ + 1) {
+            break;
+        }
+    }
+
+    out = bestId;
+    return Lookup::FOUND;
+}
+
+bool IdleRobotIndex::nearestByScan(Position target, RobotId& out) const {
+    if (where_.empty()) {
+        return false;
+    }
+    int bestDistance = std::numeric_limits<int>::max();
+    RobotId bestId = 0;
+    for (const auto& [id, pos] : where_) {
+        const int dist = manhattan(pos, target);
+        if (dist < bestDistance || (dist == bestDistance && id < bestId)) {
+            bestDistance = dist;
+            bestId = id;
+        }
+    }
+    out = bestId;
+    return true;
+}
+
+int IdleRobotIndex::bucketOf(int coord) const {
+    return coord >= 0 ? coord / bucketSize_ : -((-coord + bucketSize_ - 1) / bucketSize_);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "common/types.hpp"
+
+// Spatial index of idle robots of one type for nearest-idle lookups.
+// Robots are hashed into square buckets of a uniform grid; a query scans rings of buckets
+// around the target and stops as soon as no farther ring can hold a closer robot. When the idle
+// robots are sparse and far away, reaching them would probe more (mostly empty) buckets than there
+// are robots, so the ring search gives up and a plain pass over the robots answers instead.
+class IdleRobotIndex {
+public:
+    enum class Lookup {
+        FOUND,
+        EMPTY,
+        TOO_SPARSE   // the ring search hit its probe budget; ask nearestByScan (or another linear pass)
+    };
+
+    explicit IdleRobotIndex(int bucketSize = 8) : bucketSize_(bucketSize > 0 ? bucketSize : 1) {}
+
+    void clear();
+    // add the robot, or move it if it is already indexed
+    void insert(RobotId id, Position pos);
+    void remove(RobotId id);
+    bool contains(RobotId id) const { return where_.count(id) > 0; }
+    std::size_t size() const { return where_.size(); }
+
+    // visit every indexed robot as fn(id, position), in no particular order
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& [id, pos] : where_) {
+            fn(id, pos);
+        }
+    }
+
+    // nearest indexed robot by Manhattan distance (ties go to the lowest id); false if empty.
+    // Never probes more than max(size(), 9) buckets before falling back to nearestByScan.
+    bool nearest(Position target, RobotId& out) const;
+    // the ring search alone, within the probe budget
+    Lookup findNearby(Position target, RobotId& out) const;
+    // one pass over every indexed robot, same answer as nearest(); false if empty
+    bool nearestByScan(Position target, RobotId& out) const;
+
+private:
+    struct Entry {
+        RobotId  id;
+        Position pos;
+    };
+
+    int bucketOf(int coord) const;   // floor division, also correct for negative coordinates
+    static std::uint64_t keyOf(int bx, int by) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(bx)) << 32) | static_cast<std::uint32_t>(by);
+    }
+
+    int bucketSize_;
+    std::unordered_map<std::uint64_t, std::vector<Entry>> buckets_;
+    std::unordered_map<RobotId, Position> where_;
+    // bounding box of the buckets used since the last clear(), limits how far a query searches
+    int minBx_{0}, maxBx_{-1}, minBy_{0}, maxBy_{-1};
+};
@@ -2,6 +2,10 @@
 #include <atomic>
 #include "common/types.hpp"
 
+// Reserved recipient id: a command addressed to it is delivered to every robot.
+// IdGenerator starts at 1, so no real robot ever gets this id.
+constexpr RobotId kBroadcastId = 0;
+
 struct IdGenerator {
     static RobotId next() {
         static std::atomic<RobotId> counter{1};
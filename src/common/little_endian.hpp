@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Byte-order helpers for the binary formats (message frames, feed files, checkpoints): fields are
+// little-endian whatever the host, and the byte loops compile down to plain loads and stores on x86.
+// Signed values are stored in two's complement.
+
+template<typename T>
+T readLE(const std::uint8_t* p) {
+    using U = std::make_unsigned_t<T>;
+    U value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<U>(static_cast<U>(p[i]) << (8 * i));
+    }
+    return static_cast<T>(value);
+}
+
+template<typename T>
+void writeLE(std::uint8_t* p, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        p[i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8 * i));
+    }
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <cstdlib>
 #include <string>
 
 using RobotId = int;
@@ -8,7 +10,12 @@ struct Position {
     int x{0}, y{0};
 };
 
-enum class RobotState {
+// grid (Manhattan) distance between two cells
+inline int manhattan(Position a, Position b) {
+    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+}
+
+enum class RobotState : std::uint8_t {
     IDLE,
     MOVING,
     ARRIVED,
@@ -16,6 +23,14 @@ enum class RobotState {
     ERROR // Not used currently
 };
 
-enum class RobotType  {
+enum class RobotType : std::uint8_t {
     DETECTOR, VACUUM, WASHER
 };
+
+// Kind of work a robot is ordered to do / reports as done.
+enum class WorkKind : std::uint8_t {
+    NONE,    // in a StartWorkCommand: "your usual work" (each robot type has one)
+    DETECT,
+    VACUUM,
+    WASH
+};
@@ -0,0 +1,71 @@
+#include "control_unit/cell_set.hpp"
+
+#include <algorithm>
+
+void CellSet::reset(int width, int height, MapStorage storage) {
+    width_ = std::max(width, 0);
+    height_ = std::max(height, 0);
+    storage_ = storage;
+    size_ = 0;
+    sparse_.clear();
+    if (storage_ == MapStorage::DENSE) {
+        const std::size_t cells = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+        bits_.assign((cells + 63) / 64, 0);
+    } else {
+        bits_.clear();
+        bits_.shrink_to_fit();
+    }
+}
+
+void CellSet::clear() {
+    if (size_ == 0) {
+        return;
+    }
+    std::fill(bits_.begin(), bits_.end(), 0);
+    sparse_.clear();
+    size_ = 0;
+}
+
+bool CellSet::insert(Position p) {
+    if (!inBounds(p)) {
+        return false;
+    }
+    const std::uint64_t idx = indexOf(p);
+    if (storage_ == MapStorage::SPARSE) {
+        const bool inserted = sparse_.insert(idx).second;
+        size_ += inserted;
+        return inserted;
+    }
+    std::uint64_t& word = bits_[idx / 64];
+    const std::uint64_t mask = std::uint64_t{1} << (idx % 64);
+    const bool inserted = (word & mask) == 0;
+    word |= mask;
+    size_ += inserted;
+    return inserted;
+}
+
+void CellSet::erase(Position p) {
+    if (!inBounds(p)) {
+        return;
+    }
+    const std::uint64_t idx = indexOf(p);
+    if (storage_ == MapStorage::SPARSE) {
+        size_ -= sparse_.erase(idx);
+        return;
+    }
+    std::uint64_t& word = bits_[idx / 64];
+    const std::uint64_t mask = std::uint64_t{1} << (idx % 64);
+    size_ -= (word & mask) != 0;
+    word &= ~mask;
+}
+
+bool CellSet::contains(Position p) const {
+    if (!inBounds(p)) {
+        return false;
+    }
+    const std::uint64_t idx = indexOf(p);
+    if (storage_ == MapStorage::SPARSE) {
+        return sparse_.count(idx) > 0;
+    }
+    return (bits_[idx / 64] >> (idx % 64)) & 1;
+}
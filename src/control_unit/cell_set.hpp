@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "common/types.hpp"
+#include "environment/environment_map.hpp"
+
+// Membership set of grid cells, used to keep a cell from being queued twice.
+// DENSE keeps one bit per cell of the floor, so insert/erase/contains are a shift and a mask with
+// no allocation; SPARSE (for huge, mostly-clean floors) hashes the indices of the member cells.
+// Cells outside the floor given to reset() are never members.
+class CellSet {
+public:
+    // size the set for a width x height floor and empty it
+    void reset(int width, int height, MapStorage storage = MapStorage::DENSE);
+    void clear();
+
+    // true if the cell was not a member yet
+    bool insert(Position p);
+    void erase(Position p);
+    bool contains(Position p) const;
+    std::size_t size() const { return size_; }
+
+private:
+    bool inBounds(Position p) const { return p.x >= 0 && p.y >= 0 && p.x < width_ && p.y < height_; }
+    std::uint64_t indexOf(Position p) const {
+        return static_cast<std::uint64_t>(p.y) * static_cast<std::uint64_t>(width_) + static_cast<std::uint64_t>(p.x);
+    }
+
+    int width_{0};
+    int height_{0};
+    MapStorage storage_{MapStorage::DENSE};
+    std::size_t size_{0};
+    std::vector<std::uint64_t> bits_;          // DENSE: bit i set <=> cell i is a member
+    std::unordered_set<std::uint64_t> sparse_; // SPARSE: indices of the member cells
+};
@@ -0,0 +1,190 @@
+#include "control_unit/checkpoint.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/little_endian.hpp"
+#include "logging/log.hpp"
+
+// ---- helper functions inside anonymous namespace ----
+namespace {
+constexpr std::uint32_t kCheckpointMagic = 0x50434352;   // "RCCP"
+constexpr std::uint16_t kCheckpointVersion = 1;
+constexpr std::size_t kHeaderSize = 64;
+
+std::uint64_t indexOf(const EnvironmentMap& map, Position p) {
+    return static_cast<std::uint64_t>(p.y) * static_cast<std::uint64_t>(map.width()) + static_cast<std::uint64_t>(p.x);
+}
+
+// buffered u64 writer over a FILE*, remembering whether any write failed
+class SectionWriter {
+public:
+    explicit SectionWriter(std::FILE* file) : file_(file) {}
+    void put(std::uint64_t value) {
+        if (used_ == sizeof(buffer_)) {
+            flush();
+        }
+        writeLE(buffer_ + used_, value);
+        used_ += sizeof(value);
+    }
+    bool finish() {
+        flush();
+        return ok_;
+    }
+
+private:
+    void flush() {
+        ok_ = ok_ && std::fwrite(buffer_, 1, used_, file_) == used_;
+        used_ = 0;
+    }
+
+    std::FILE* file_;
+    std::uint8_t buffer_[1 << 16];
+    std::size_t used_{0};
+    bool ok_{true};
+};
+}
+
+bool writeCheckpoint(const std::string& path, const EnvironmentMap& map, const CheckpointState& state) {
+    const std::string tmpPath = path + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        LOG_ERROR("[Checkpoint] cannot create ", tmpPath);
+        return false;
+    }
+
+    std::string patterns;
+    for (const std::string& name : state.patterns) {
+        patterns += patterns.empty() ? name : "\n" + name;
+    }
+
+    // the header is written last, once the number of cells is known
+    bool ok = std::fseek(file, static_cast<long>(kHeaderSize), SEEK_SET) == 0;
+    SectionWriter out(file);
+    std::uint64_t cells = 0;
+    map.forEachNonClean([&](std::uint64_t idx, CellState cell) {
+        out.put(idx << 2 | static_cast<std::uint64_t>(cell));
+        ++cells;
+    });
+    for (const Position& p : state.vacuumQueue) {
+        out.put(indexOf(map, p));
+    }
+    for (const Position& p : state.washerQueue) {
+        out.put(indexOf(map, p));
+    }
+    for (std::uint64_t progress : state.detectorProgress) {
+        out.put(progress);
+    }
+    ok = out.finish() && ok;
+    ok = ok && std::fwrite(patterns.data(), 1, patterns.size(), file) == patterns.size();
+
+    std::uint8_t header[kHeaderSize] = {};
+    writeLE(header + 0, kCheckpointMagic);
+    writeLE(header + 4, kCheckpointVersion);
+    header[6] = static_cast<std::uint8_t>(map.storage());
+    writeLE(header + 8, static_cast<std::uint32_t>(map.width()));
+    writeLE(header + 12, static_cast<std::uint32_t>(map.height()));
+    writeLE(header + 16, cells);
+    writeLE(header + 24, static_cast<std::uint64_t>(state.vacuumQueue.size()));
+    writeLE(header + 32, static_cast<std::uint64_t>(state.washerQueue.size()));
+    writeLE(header + 40, static_cast<std::uint32_t>(state.detectorProgress.size()));
+    writeLE(header + 44, static_cast<std::uint32_t>(patterns.size()));
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(header, sizeof(header), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("[Checkpoint] failed writing ", path);
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool readCheckpoint(const std::string& path, EnvironmentMap& map, CheckpointState& state) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("[Checkpoint] cannot open ", path);
+        return false;
+    }
+    struct stat st {};
+    void* mem = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= kHeaderSize) {
+        mem = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        LOG_ERROR("[Checkpoint] ", path, " is not a checkpoint");
+        return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    ::madvise(mem, size, MADV_SEQUENTIAL);
+    const auto* data = static_cast<const std::uint8_t*>(mem);
+
+    const int width = static_cast<int>(readLE<std::uint32_t>(data + 8));
+    const int height = static_cast<int>(readLE<std::uint32_t>(data + 12));
+    const std::uint64_t cells = readLE<std::uint64_t>(data + 16);
+    const std::uint64_t vacuums = readLE<std::uint64_t>(data + 24);
+    const std::uint64_t washers = readLE<std::uint64_t>(data + 32);
+    const std::uint32_t detectors = readLE<std::uint32_t>(data + 40);
+    const std::uint32_t patternBytes = readLE<std::uint32_t>(data + 44);
+    const std::uint64_t words = size / 8;   // bounds every count before the sum below can overflow
+    const bool valid = readLE<std::uint32_t>(data) == kCheckpointMagic
+                    && readLE<std::uint16_t>(data + 4) == kCheckpointVersion && data[6] <= 1
+                    && cells <= words && vacuums <= words && washers <= words
+                    && size == kHeaderSize + 8 * (cells + vacuums + washers + detectors) + patternBytes;
+    const MapStorage storage = data[6] == 0 ? MapStorage::DENSE : MapStorage::SPARSE;
+    if (!valid || !map.resetGrid(width, height, storage, static_cast<std::size_t>(cells))) {
+        LOG_ERROR("[Checkpoint] ", path, " is malformed");
+        ::munmap(mem, size);
+        return false;
+    }
+
+    const std::uint8_t* p = data + kHeaderSize;
+    auto next = [&p] {
+        const auto value = readLE<std::uint64_t>(p);
+        p += 8;
+        return value;
+    };
+    bool ok = true;
+    for (std::uint64_t i = 0; ok && i < cells; ++i) {
+        const std::uint64_t entry = next();
+        ok = (entry & 3) <= static_cast<std::uint64_t>(CellState::VACUUMED)
+          && map.addCell(entry >> 2, static_cast<CellState>(entry & 3));
+    }
+    const std::uint64_t floorCells = map.cellCount();
+    auto readQueue = [&](std::uint64_t count, std::vector<Position>& queue) {
+        queue.clear();
+        queue.reserve(static_cast<std::size_t>(count));
+        for (std::uint64_t i = 0; ok && i < count; ++i) {
+            const std::uint64_t idx = next();
+            ok = idx < floorCells;
+            queue.push_back(Position{static_cast<int>(idx % static_cast<std::uint64_t>(width)),
+                                     static_cast<int>(idx / static_cast<std::uint64_t>(width))});
+        }
+    };
+    readQueue(vacuums, state.vacuumQueue);
+    readQueue(washers, state.washerQueue);
+    state.detectorProgress.assign(detectors, 0);
+    for (std::uint32_t i = 0; ok && i < detectors; ++i) {
+        state.detectorProgress[i] = next();
+    }
+    state.patterns.clear();
+    if (ok && patternBytes > 0) {
+        const std::string names(reinterpret_cast<const char*>(p), patternBytes);
+        for (std::size_t begin = 0; begin <= names.size();) {
+            const std::size_t end = std::min(names.find('\n', begin), names.size());
+            state.patterns.push_back(names.substr(begin, end - begin));
+            begin = end + 1;
+        }
+    }
+    ::munmap(mem, size);
+
+    if (!ok) {
+        LOG_ERROR("[Checkpoint] ", path, " does not fit its ", width, "x", height, " floor");
+    }
+    return ok;
+}
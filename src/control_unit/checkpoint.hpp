@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/types.hpp"
+#include "environment/environment_map.hpp"
+
+// Snapshot of a run in progress, so that a restarted process resumes instead of rescanning the floor.
+//
+// Only what cannot be recomputed is stored, so the file grows with the remaining work, not with the floor.
+// A 64-byte header is followed by the sections below; all fields are little-endian:
+//   u32 magic "RCCP" | u16 version | u8 MapStorage | u8 reserved | i32 width | i32 height |
+//   u64 cells | u64 vacuum queue | u64 washer queue | u32 detectors | u32 pattern bytes | 16 reserved
+//   cells:           u64 (row-major index << 2 | CellState) per cell that is not CLEAN
+//   queues:          u64 row-major index per queued cell, vacuum queue first, in queue order
+//   detectors:       u64 cells of its scan path each detector has scanned
+//   scan patterns:   names separated by '\n'
+// readCheckpoint maps the file and streams the cells straight into the map.
+
+struct CheckpointState {
+    std::vector<std::string>   patterns;           // planner patterns, handed to detectors round-robin
+    std::vector<Position>      vacuumQueue;        // cells still to vacuum, in dispatch order
+    std::vector<Position>      washerQueue;        // cells still to wash, in dispatch order
+    std::vector<std::uint64_t> detectorProgress;   // per detector, in registry order
+};
+
+// write map + state to `path` atomically (a temporary file renamed over it); false on I/O errors
+bool writeCheckpoint(const std::string& path, const EnvironmentMap& map, const CheckpointState& state);
+// load a snapshot: reset `map` to its floor and cells and fill `state`; false (and a LOG_ERROR) if the file is missing, malformed or does not fit its floor
+bool readCheckpoint(const std::string& path, EnvironmentMap& map, CheckpointState& state);
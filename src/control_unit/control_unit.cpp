@@ -1,110 +1,135 @@
 #include <iostream>
-#include <cstdlib>
-#include <limits>
-#include <set>
+#include <algorithm>
+#include <thread>
 #include <utility>
 #include <vector>
 #include <variant>
 #include <type_traits>
 #include "control_unit/control_unit.hpp"
+#include "environment/feed_file.hpp"
+#include "logging/log.hpp"
+#include "planner/assignment.hpp"
 
 // ---- helper functions inside anonymous namespace ----
 namespace {
-using CellKey = std::pair<int, int>;
-CellKey cellKey(Position p) {
-    return {p.x, p.y};
-}
 bool samePosition(Position a, Position b) {
     return a.x == b.x && a.y == b.y;
 }
-// can be optimized later if needed
-int distance(Position a, Position b) {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
-}
 }
 
 // ---- command helpers - create and send commands via the bus ----
 
 void ControlUnit::sendMoveCmd(RobotId id, Position dst) {
+    syncClock(id);
     MoveCommand cmd;
     cmd.to = id;
     cmd.position = dst;
-    bus_.broadcast(std::move(cmd));
+    bus_.send(std::move(cmd));
+    recordCommand();
 }
 
-void ControlUnit::sendStartRobotWorkCmd(RobotId id, const std::string& kind) {
+void ControlUnit::sendStartRobotWorkCmd(RobotId id, WorkKind kind) {
+    syncClock(id);
     StartWorkCommand cmd;
     cmd.to = id;
     cmd.kind = kind;
-    bus_.broadcast(std::move(cmd));
+    bus_.send(std::move(cmd));
+    recordCommand();
 }
 
 void ControlUnit::sendStopRobotCmd(RobotId id) {
     StopCommand cmd;
     cmd.to = id;
-    bus_.broadcast(std::move(cmd));
+    bus_.send(std::move(cmd));
+    recordCommand();
 }
 
 // ---- event processing ----
 
 void ControlUnit::drainEvents() {
-    Bus::EventVariant event;
-    while (bus_.poll(event)) {
-        handleEvent(event);
+    // the main thread also runs the detection stage, so the detector batch buffer is its own
+    drainBus(bus_, eventBatch_[static_cast<std::size_t>(RobotType::DETECTOR)]);
+}
+
+void ControlUnit::drainEventsOf(RobotType type) {
+    const auto idx = static_cast<std::size_t>(type);
+    drainBus(*eventSource_[idx], eventBatch_[idx]);
+}
+
+void ControlUnit::drainBus(Bus& source, std::vector<Bus::EventVariant>& batch) {
+    // take events in batches; handlers may publish new events, those arrive in the next batch
+    while (source.pollBatch(batch, kEventBatchSize) > 0) {
+        recordEvents(batch.size());
+        std::size_t begin = 0;
+        while (begin < batch.size()) {
+            // extend the run while consecutive events share the same type
+            const std::size_t kind = batch[begin].index();
+            std::size_t end = begin + 1;
+            while (end < batch.size() && batch[end].index() == kind) {
+                ++end;
+            }
+            handleEventRun(batch, begin, end);
+            begin = end;
+        }
     }
 }
 
 // ---- event handling helpers ----
 
-// dispatch event to the appropriate handler based on its type
-void ControlUnit::handleEvent(const Bus::EventVariant& event) {
-    // lambda visitor to process each event type
-    std::visit([this](const auto& ev) {
-        using EventType = std::decay_t<decltype(ev)>;
-        if constexpr (std::is_same_v<EventType, StatusEvent>) {
-            handleStatusEvent(ev);
-        } else if constexpr (std::is_same_v<EventType, WorkCompletedEvent>) {
-            handleWorkCompletedEvent(ev);
-        } else if constexpr (std::is_same_v<EventType, DetectionEvent>) {
-            // Detection events not used currently, the detection simulation is implicit in the CU logic for now
-            (void)ev;
+// dispatch a homogeneous run of batched events [begin, end) to the appropriate handler
+void ControlUnit::handleEventRun(const std::vector<Bus::EventVariant>& batch, std::size_t begin, std::size_t end) {
+    // visit once per run, then handle every event in it with the resolved type
+    std::visit([this, &batch, begin, end](const auto& first) {
+        using EventType = std::decay_t<decltype(first)>;
+        for (std::size_t i = begin; i < end; ++i) {
+            const EventType& ev = *std::get_if<EventType>(&batch[i]);
+            if constexpr (std::is_same_v<EventType, StatusEvent>) {
+                handleStatusEvent(ev);
+            } else if constexpr (std::is_same_v<EventType, WorkCompletedEvent>) {
+                handleWorkCompletedEvent(ev);
+            } else if constexpr (std::is_same_v<EventType, DetectionEvent>) {
+                // Detection events not used currently, the detection simulation is implicit in the CU logic for now
+                (void)ev;
+            }
         }
-    }, event);
+    }, batch[begin]);
 }
 
-// handle status event - currently only process ARRIVED state
+// handle status event - keep the idle index current, then process ARRIVED state
 void ControlUnit::handleStatusEvent(const StatusEvent& event) {
-    // only care about ARRIVED state for now
+    updateIdleIndex(event);
+    scheduleWake(event);
+
+    // only care about ARRIVED state for the task flow
     if (event.state != RobotState::ARRIVED) {
         return;
     }
 
     // find pending task for this robot
-    auto it = pendingTasks_.find(event.from);
-    if (it == pendingTasks_.end()) {
+    auto& pending = pendingFor(event.type);
+    auto it = pending.find(event.from);
+    if (it == pending.end()) {
         return;
     }
 
     // start the work
     const PendingTask& task = it->second;
-    std::cout << "[CU] Robot " << event.from << " arrived at ("
-              << event.position.x << "," << event.position.y
-              << ") -> start " << task.kind << "\n";
+    LOG_DEBUG("[CU] Robot ", event.from, " arrived at (",
+              event.position.x, ",", event.position.y,
+              ") -> start ", workKindName(task.kind));
     sendStartRobotWorkCmd(event.from, task.kind);
 }
 
 // handle work completed event
 void ControlUnit::handleWorkCompletedEvent(const WorkCompletedEvent& event) {
-    std::cout << "[CU] Robot " << event.from << " completed "
-              << event.workKind << " at ("
-              << event.position.x << "," << event.position.y << ")"
-              << (event.success ? "" : " with failure")
-              << "\n";
+    LOG_DEBUG("[CU] Robot ", event.from, " completed ",
+              workKindName(event.workKind), " at (",
+              event.position.x, ",", event.position.y, ")",
+              event.success ? "" : " with failure");
 
     // remove from pending tasks
-    auto taskIt = pendingTasks_.find(event.from);
-    if (taskIt != pendingTasks_.end()) {
-        pendingTasks_.erase(taskIt);
+    if (RobotBase* robot = reg_.find(event.from)) {
+        pendingFor(robot->type()).erase(event.from);
     }
 
     // check success
@@ -113,41 +138,92 @@ void ControlUnit::handleWorkCompletedEvent(const WorkCompletedEvent& event) {
     }
 
     // post-process based on work kind
-    if (event.workKind == "VACUUM") {
+    if (event.workKind == WorkKind::VACUUM) {
         if (map_.markVacuumed(event.position)) {
-            if (queuedForWasher_.insert(cellKey(event.position)).second) {
-                washerQueue_.push(event.position);
-            }
+            enqueueWasherTask(event.position);
         }
-    } else if (event.workKind == "WASH") {
+    } else if (event.workKind == WorkKind::WASH) {
         map_.markWashed(event.position);
     }
 }
 
+// ---- fleet changes ----
+
+bool ControlUnit::removeRobot(RobotId id) {
+    RobotBase* robot = reg_.find(id);
+    if (!robot) {
+        return false;
+    }
+    // the bus holds a raw pointer to the robot: unsubscribe it before the registry may destroy it
+    const RobotType type = robot->type();
+    bus_.detach(id);
+    idleIndexFor(type).remove(id);
+    pendingFor(type).erase(id);
+    return reg_.remove(id);
+}
+
 // ---- utility functions, not in use yet ----
 
 void ControlUnit::printRobots() const {
-    auto printVec = [](const std::vector<std::shared_ptr<RobotBase>>& vec) {
-        for (const auto& r : vec) {
+    auto printVec = [](RobotRange robots) {
+        for (const RobotBase* r : robots) {
             std::cout << "[CU] Robot ID=" << r->id()
                       << " Type="  << static_cast<int>(r->type())
                       << " State=" << static_cast<int>(r->state()) << "\n";
         }
     };
-    printVec(reg_.getByType(RobotType::DETECTOR));
-    printVec(reg_.getByType(RobotType::VACUUM));
-    printVec(reg_.getByType(RobotType::WASHER));
+    printVec(reg_.ofType(RobotType::DETECTOR));
+    printVec(reg_.ofType(RobotType::VACUUM));
+    printVec(reg_.ofType(RobotType::WASHER));
 }
 
 ///////////////////////////////////////// MAIN SIMULATION ////////////////////////////////////////////////////////
 
 // create environment map (size and dirt spots) and configure planner
 void ControlUnit::seedFrom(const BootstrapFeed& feed) {
-    if (!map_.initializeGrid(feed.gridWidth, feed.gridHeight, feed.dirtSpots)) {
-        std::cerr << "[CU] failed to initialize grid; aborting scenario.\n";
+    restorePending_ = false;
+    if (!map_.initializeGrid(feed.gridWidth, feed.gridHeight, feed.dirtSpots, feed.storage)) {
+        LOG_ERROR("[CU] failed to initialize grid; aborting scenario.");
         return;
     }
     planner_.configureGrid(feed.gridWidth, feed.gridHeight);
+    if (!planner_.setPatterns(feed.scanPatterns)) {
+        LOG_WARN("[CU] unknown scan pattern in feed; keeping the planner defaults.");
+    }
+}
+
+void ControlUnit::setCheckpoint(const std::string& path, std::size_t everyRounds) {
+    checkpointPath_ = path;
+    checkpointEvery_ = path.empty() ? 0 : everyRounds;
+}
+
+bool ControlUnit::restoreFrom(const std::string& path) {
+    CheckpointState state;
+    if (!readCheckpoint(path, map_, state)) {
+        LOG_ERROR("[CU] cannot restore from ", path);
+        return false;
+    }
+    planner_.configureGrid(map_.width(), map_.height());
+    if (!state.patterns.empty() && !planner_.setPatterns(state.patterns)) {
+        LOG_WARN("[CU] unknown scan pattern in snapshot; keeping the planner defaults.");
+    }
+    restored_ = std::move(state);
+    restorePending_ = true;
+    return true;
+}
+
+bool ControlUnit::seedFromFile(const std::string& path, const std::vector<std::string>& scanPatterns) {
+    restorePending_ = false;
+    const FeedFile feed = FeedFile::open(path);
+    if (!feed.loadInto(map_)) {
+        LOG_ERROR("[CU] failed to load feed file ", path, "; aborting scenario.");
+        return false;
+    }
+    planner_.configureGrid(feed.width(), feed.height());
+    if (!planner_.setPatterns(scanPatterns)) {
+        LOG_WARN("[CU] unknown scan pattern; keeping the planner defaults.");
+    }
+    return true;
 }
 
 
@@ -158,106 +234,168 @@ void ControlUnit::run() {
 
     // check planner configured
     if (!planner_.isConfigured()) {
-        std::cerr << "[CU] planner not configured. Did you call seedFrom()?\n";
+        LOG_ERROR("[CU] planner not configured. Did you call seedFrom()?");
         return;
     }
 
     // Resetting queues and bookkeeping
-    vacuumQueue_ = std::queue<Position>{};
-    washerQueue_ = std::queue<Position>{};
-    queuedForVacuum_.clear();
-    queuedForWasher_.clear();
-    pendingTasks_.clear();
+    if constexpr (kMetricsEnabled) {
+        metrics_ = std::make_unique<RunMetrics>();
+    }
+    vacuumQueue_ = std::queue<QueuedCell>{};
+    washerQueue_ = std::queue<QueuedCell>{};
+    queuedForVacuum_.reset(map_.width(), map_.height(), map_.storage());
+    queuedForWasher_.reset(map_.width(), map_.height(), map_.storage());
+    for (auto& pending : pendingTasks_) {
+        pending.clear();
+    }
+    travelDistance_ = 0;
+    roundsSinceCheckpoint_ = 0;
+    stats_ = SimulationStats{};
+    totalQueueWait_ = 0;
+    wakeups_ = {};
+    scheduledBusy_.fill(0);
+    for (RobotBase* robot : reg_.all()) {
+        robot->setTiming(simMode_ == SimulationMode::INSTANT ? RobotTiming{}
+                                                             : timing_[static_cast<std::size_t>(robot->type())]);
+    }
     drainEvents();
+    rebuildIdleIndex();
 
     // Assigning plan to each Detector
-    auto detectorsVec = reg_.getByType(RobotType::DETECTOR);
+    const RobotRange detectorsVec = reg_.ofType(RobotType::DETECTOR);
     if (detectorsVec.empty()) {
-        std::cerr << "[CU] no detector robots available\n";
+        LOG_ERROR("[CU] no detector robots available");
         return;
     }
     auto plans = planner_.buildScanPlans(detectorsVec.size());
     if (plans.size() != detectorsVec.size()) {
-        std::cerr << "[CU] unable to build scan plans\n";
+        LOG_ERROR("[CU] unable to build scan plans");
         return;
     }
 
-    // Bookkeeping block that packages each detector state in one "detectors" vector:
-    struct DetectorState {
-        std::shared_ptr<RobotBase> robot;
-        std::vector<Position>      path;
-        std::size_t                nextIndex{0};
-        bool                       started{false};
-        bool                       finished{false};
-    };
+    // package each detector state in one "detectors" vector
     std::vector<DetectorState> detectors;
     detectors.reserve(detectorsVec.size());
     for (std::size_t idx = 0; idx < detectorsVec.size(); ++idx) {
         detectors.push_back(DetectorState{
             detectorsVec[idx],
-            plans[idx],
-            0,
+            std::move(plans[idx]),
             false,
             false
         });
     }
 
-    const Position start = {0, 0};
+    if (restorePending_) {
+        resumeRestored(detectors);
+    }
+    const bool pipelined = simMode_ == SimulationMode::INSTANT && mode_ == ExecutionMode::PIPELINED;
+    if (pipelined && checkpointEvery_ > 0) {
+        LOG_WARN("[CU] pipelined stages own the task queues; no checkpoints are written for this run.");
+    }
 
-    // Advancing each Detector one step according to the assigned path (Lambda):
-    auto processDetectors = [&]() -> bool {
-        bool madeProgress = false;
+    if (simMode_ != SimulationMode::INSTANT) {
+        if (mode_ == ExecutionMode::PIPELINED) {
+            LOG_WARN("[CU] pipelined execution needs instant robots; running the timed simulation serially.");
+        }
+        if (simMode_ == SimulationMode::EVENT_DRIVEN) {
+            runEventDriven(detectors);
+        } else {
+            runTimeStepped(detectors);
+        }
+    } else if (mode_ == ExecutionMode::PIPELINED) {
+        runPipelined(detectors);
+    } else {
+        runSerial(detectors);
+    }
 
-        // process each detector state
-        for (std::size_t i = 0; i < detectors.size(); ++i) {
-            DetectorState& state = detectors[i];
-            // if not started yet
-            if (!state.started) {
-                std::cout << "[Detector#" << state.robot->name() << "] start scan\n";
-                state.started = true;
-                madeProgress = true;
-            }
-            // if finished already
-            if (state.finished) {
-                continue;
-            }
-            // if Path ended
-            if (state.nextIndex >= state.path.size()) {
-                if (!samePosition(state.robot->position(), start)) {
-                    sendMoveCmd(state.robot->id(), start);
-                    drainEvents();
-                    madeProgress = true;
-                }
-                state.finished = true;
+    if (!pipelined && checkpointEvery_ > 0) {
+        writeCheckpointNow(detectors);
+    }
+
+    LOG_INFO("[CU] total travel distance: ", travelDistance(),
+             policy_ == AssignmentPolicy::BATCH ? " (batch assignment)" : " (greedy assignment)");
+    if constexpr (kMetricsEnabled) {
+        metrics_->dump();
+    }
+    // log output is asynchronous; have it all written before the caller prints anything else
+    Log::flush();
+}
+
+// Advancing each Detector one step according to the assigned path
+bool ControlUnit::processDetectors(std::vector<DetectorState>& detectors) {
+    const Position start = {0, 0};
+    bool madeProgress = false;
+
+    // process each detector state
+    for (std::size_t i = 0; i < detectors.size(); ++i) {
+        DetectorState& state = detectors[i];
+        // if not started yet
+        if (!state.started) {
+            LOG_DEBUG("[Detector#", state.robot->name(), "] start scan");
+            state.started = true;
+            madeProgress = true;
+        }
+        // if finished already
+        if (state.finished) {
+            continue;
+        }
+        // a timed detector scans its cell once it got there
+        if (state.scanPending) {
+            if (state.robot->state() == RobotState::MOVING) {
                 continue;
             }
-            // get next cell in path
-            Position cell = state.path[state.nextIndex++];
+            state.scanPending = false;
+            scanCell(state, state.scanTarget);
             madeProgress = true;
-
-            // Move to position
-            if (!samePosition(state.robot->position(), cell)) {
-                sendMoveCmd(state.robot->id(), cell);
-                drainEvents();
+        }
+        // get next cell in path - if Path ended, return to start
+        Position cell;
+        if (!state.path.next(cell)) {
+            if (!samePosition(state.robot->position(), start)) {
+                sendMoveCmd(state.robot->id(), start);
+                drainEventsOf(RobotType::DETECTOR);
+                madeProgress = true;
             }
+            state.finished = true;
+            continue;
+        }
+        madeProgress = true;
 
-            // Call vacuum robot if needed
-            if (map_.hasDirt(cell)) {
-                if (enqueueVacuumTask(cell)) {
-                    std::cout << "[Detector#" << state.robot->name()
-                              << "] detected dirt at (" << cell.x << "," << cell.y << ")\n";
-                }
-            }
+        // Move to position
+        if (!samePosition(state.robot->position(), cell)) {
+            sendMoveCmd(state.robot->id(), cell);
+            drainEventsOf(RobotType::DETECTOR);
         }
 
-        return madeProgress;
-    };
+        // Call vacuum robot if needed - right away, or once a timed detector has arrived
+        if (samePosition(state.robot->position(), cell)) {
+            scanCell(state, cell);
+        } else {
+            state.scanPending = true;
+            state.scanTarget = cell;
+        }
+    }
 
-    //////////////////// The Main Loop:
+    return madeProgress;
+}
+
+void ControlUnit::scanCell(const DetectorState& state, Position cell) {
+    if (map_.hasDirt(cell)) {
+        if (enqueueVacuumTask(cell)) {
+            LOG_DEBUG("[Detector#", state.robot->name(),
+                      "] detected dirt at (", cell.x, ",", cell.y, ")");
+        }
+    }
+}
+
+//////////////////// The Main Loop (SERIAL):
 
+void ControlUnit::runSerial(std::vector<DetectorState>& detectors) {
     while (true) {
+        checkpointRound(detectors);
         // Each iteration tries to advance detectors and assign tasks to vacuums and washers
-        bool detectorsProgress = processDetectors();
+        bool detectorsProgress = processDetectors(detectors);
         bool vacuumProgress = processVacuumQueue();
         bool washerProgress = processWasherQueue();
 
@@ -277,20 +415,387 @@ void ControlUnit::run() {
 
         // safety check: if no progress made in this iteration, break to avoid infinite loop
         if (!detectorsProgress && !vacuumProgress && !washerProgress) {
-            std::cerr << "[CU] run loop made no progress; aborting.\n";
+            LOG_ERROR("[CU] run loop made no progress; aborting.");
+            break;
+        }
+    }
+}
+
+//////////////////// The Main Loop (TIME_STEPPED):
+//
+// Same decisions as the serial loop, but robots take time: once nothing more can be dispatched the
+// clock advances one tick, robots move/work up to it and report arrivals and completions.
+// The run ends when the detectors are done, the queues are empty and no robot is moving or working.
+
+void ControlUnit::runTimeStepped(std::vector<DetectorState>& detectors) {
+    const unsigned long long start = now_;
+    std::array<unsigned long long, 3> busyTicks{};
+    std::array<std::size_t, 3> busy{};
+
+    while (true) {
+        checkpointRound(detectors);
+        bool progress = processDetectors(detectors);
+        progress = processVacuumQueue() || progress;
+        progress = processWasherQueue() || progress;
+        // keep deciding at this tick until nothing more can be done without time passing
+        if (progress) {
+            continue;
+        }
+
+        const bool allDetectorsFinished = std::all_of(detectors.begin(), detectors.end(),
+                                                      [](const DetectorState& state) { return state.finished; });
+        const bool anyBusy = countBusyRobots(busy, &ticking_);
+        if (allDetectorsFinished && vacuumQueue_.empty() && washerQueue_.empty() && !anyBusy) {
+            break;
+        }
+        // nothing moves and nothing could be dispatched: waiting cannot help
+        if (!anyBusy) {
+            LOG_ERROR("[CU] simulation stalled at tick ", now_ - start, "; aborting.");
+            break;
+        }
+
+        // the robots busy now stay busy during the coming tick; only they need to see it
+        for (std::size_t type = 0; type < busy.size(); ++type) {
+            busyTicks[type] += busy[type];
+        }
+        ++now_;
+        tickRobots(ticking_);
+    }
+
+    reportSimulation(start, busyTicks);
+}
+
+//////////////////// The Main Loop (EVENT_DRIVEN):
+//
+// Robots only change state when a move or a piece of work completes, so instead of ticking every
+// robot through every tick, each MOVING/WORKING status schedules the robot's completion time in a
+// min-heap. The clock jumps to the earliest completion, only the robots due then are ticked, and
+// dispatching runs again. Decisions are taken at the same ticks and in the same order as in
+// TIME_STEPPED, so both modes produce the same schedule.
+
+void ControlUnit::runEventDriven(std::vector<DetectorState>& detectors) {
+    const unsigned long long start = now_;
+
+    while (true) {
+        checkpointRound(detectors);
+        bool progress = processDetectors(detectors);
+        progress = processVacuumQueue() || progress;
+        progress = processWasherQueue() || progress;
+        if (progress) {
+            continue;
+        }
+
+        if (wakeups_.empty()) {
+            const bool allDetectorsFinished = std::all_of(detectors.begin(), detectors.end(),
+                                                          [](const DetectorState& state) { return state.finished; });
+            if (!allDetectorsFinished || !vacuumQueue_.empty() || !washerQueue_.empty()) {
+                LOG_ERROR("[CU] simulation stalled at tick ", now_ - start, "; aborting.");
+            }
+            break;
+        }
+
+        // jump to the next completion and wake every robot due at that tick
+        now_ = wakeups_.top().at;
+        ticking_.clear();
+        while (!wakeups_.empty() && wakeups_.top().at == now_) {
+            ticking_.push_back(wakeups_.top().robot);
+            wakeups_.pop();
+        }
+        tickRobots(ticking_);
+    }
+
+    reportSimulation(start, scheduledBusy_);
+}
+
+//////////////////// Metrics:
+//
+// metrics_ exists from the start of run(); the hooks are empty when built with CU_METRICS=0.
+
+void ControlUnit::recordCommand() {
+    if constexpr (kMetricsEnabled) {
+        if (metrics_) {
+            metrics_->commandsSent.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ControlUnit::recordEvents(std::size_t count) {
+    if constexpr (kMetricsEnabled) {
+        if (metrics_) {
+            metrics_->eventsDrained.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+}
+
+void ControlUnit::recordQueued(RobotType type, QueuedCell& cell, std::size_t depth) {
+    if constexpr (kMetricsEnabled) {
+        if (!metrics_) {
+            return;
+        }
+        const auto t = static_cast<std::size_t>(type);
+        ++metrics_->tasksQueued[t];
+        metrics_->maxQueueDepth[t] = std::max(metrics_->maxQueueDepth[t], depth);
+        cell.queuedNs = RunMetrics::nowNs();
+    }
+}
+
+void ControlUnit::recordDispatch(RobotType type, const QueuedCell& cell) {
+    if constexpr (kMetricsEnabled) {
+        if (metrics_ && cell.queuedNs != 0) {
+            metrics_->queueLatency[static_cast<std::size_t>(type)].record(RunMetrics::nowNs() - cell.queuedNs);
+        }
+    }
+}
+
+//////////////////// Checkpoints:
+
+void ControlUnit::checkpointRound(const std::vector<DetectorState>& detectors) {
+    if (checkpointEvery_ == 0 || ++roundsSinceCheckpoint_ < checkpointEvery_) {
+        return;
+    }
+    roundsSinceCheckpoint_ = 0;
+    writeCheckpointNow(detectors);
+}
+
+void ControlUnit::writeCheckpointNow(const std::vector<DetectorState>& detectors) {
+    CheckpointState state;
+    state.patterns = planner_.patterns();
+
+    // tasks handed to robots but not finished yet come first: a restarted fleet has to redo them
+    std::vector<std::pair<RobotId, PendingTask>> pending;
+    for (const auto& perType : pendingTasks_) {
+        pending.insert(pending.end(), perType.begin(), perType.end());
+    }
+    std::sort(pending.begin(), pending.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [id, task] : pending) {
+        (task.kind == WorkKind::WASH ? state.washerQueue : state.vacuumQueue).push_back(task.target);
+    }
+    for (std::queue<QueuedCell> queue = vacuumQueue_; !queue.empty(); queue.pop()) {
+        state.vacuumQueue.push_back(queue.front().pos);
+    }
+    for (std::queue<QueuedCell> queue = washerQueue_; !queue.empty(); queue.pop()) {
+        state.washerQueue.push_back(queue.front().pos);
+    }
+
+    // a timed detector still on its way to a cell has not scanned it yet
+    for (const DetectorState& detector : detectors) {
+        state.detectorProgress.push_back(detector.path.visited() - (detector.scanPending ? 1 : 0));
+    }
+
+    if (writeCheckpoint(checkpointPath_, map_, state)) {
+        LOG_DEBUG("[CU] checkpoint written: ", state.vacuumQueue.size(), " cells to vacuum, ",
+                  state.washerQueue.size(), " to wash");
+    }
+}
+
+void ControlUnit::resumeRestored(std::vector<DetectorState>& detectors) {
+    restorePending_ = false;
+    if (restored_.detectorProgress.size() == detectors.size()) {
+        for (std::size_t i = 0; i < detectors.size(); ++i) {
+            detectors[i].path.skip(static_cast<std::size_t>(restored_.detectorProgress[i]));
+        }
+    } else {
+        LOG_WARN("[CU] snapshot was taken with ", restored_.detectorProgress.size(), " detectors, not ",
+                 detectors.size(), "; rescanning the floor.");
+    }
+    for (const Position& pos : restored_.vacuumQueue) {
+        enqueueVacuumTask(pos);
+    }
+    for (const Position& pos : restored_.washerQueue) {
+        if (map_.needsWash(pos)) {
+            enqueueWasherTask(pos);
+        }
+    }
+    LOG_INFO("[CU] resumed from snapshot: ", vacuumQueue_.size(), " cells to vacuum, ",
+             washerQueue_.size(), " to wash");
+    restored_ = CheckpointState{};
+}
+
+void ControlUnit::tickRobots(const std::vector<RobotId>& robots) {
+    // a tick makes a robot publish at most a WorkCompletedEvent and a StatusEvent
+    const std::size_t batch = std::max<std::size_t>(1, bus_.eventCapacity() / 2);
+    for (std::size_t begin = 0; begin < robots.size(); begin += batch) {
+        const std::size_t end = std::min(robots.size(), begin + batch);
+        for (std::size_t i = begin; i < end; ++i) {
+            TickCommand tick;
+            tick.to = robots[i];
+            tick.now = now_;
+            bus_.send(tick);
+            recordCommand();
+        }
+        drainEvents();
+    }
+}
+
+void ControlUnit::syncClock(RobotId id) {
+    if (simMode_ == SimulationMode::INSTANT) {
+        return;
+    }
+    TickCommand tick;
+    tick.to = id;
+    tick.now = now_;
+    bus_.send(tick);
+    recordCommand();
+}
+
+void ControlUnit::scheduleWake(const StatusEvent& event) {
+    if (simMode_ != SimulationMode::EVENT_DRIVEN
+        || (event.state != RobotState::MOVING && event.state != RobotState::WORKING)) {
+        return;
+    }
+    const RobotBase* robot = reg_.find(event.from);
+    unsigned long long at = 0;
+    if (robot && robot->nextEventTime(at)) {
+        wakeups_.push(Wake{at, event.from});
+        // moves and work run to completion, so the scheduled span is the busy time
+        scheduledBusy_[static_cast<std::size_t>(event.type)] += at - now_;
+    }
+}
+
+bool ControlUnit::countBusyRobots(std::array<std::size_t, 3>& busy, std::vector<RobotId>* ids) const {
+    busy.fill(0);
+    if (ids) {
+        ids->clear();
+    }
+    bool any = false;
+    const FleetState& fleet = reg_.fleet();
+    const RobotState* states = fleet.states();
+    const RobotType* types = fleet.types();
+    for (std::size_t slot = 0; slot < fleet.size(); ++slot) {
+        if (states[slot] == RobotState::MOVING || states[slot] == RobotState::WORKING) {
+            ++busy[static_cast<std::size_t>(types[slot])];
+            any = true;
+            if (ids) {
+                ids->push_back(fleet.id(slot));
+            }
+        }
+    }
+    return any;
+}
+
+void ControlUnit::noteDispatched(const QueuedCell& task) {
+    if (simMode_ == SimulationMode::INSTANT) {
+        return;
+    }
+    const unsigned long long wait = now_ - task.queuedTick;
+    ++stats_.tasksDispatched;
+    totalQueueWait_ += wait;
+    stats_.maxQueueWait = std::max(stats_.maxQueueWait, wait);
+}
+
+void ControlUnit::reportSimulation(unsigned long long start, const std::array<unsigned long long, 3>& busyTicks) {
+    stats_.makespan = now_ - start;
+    for (RobotType type : {RobotType::DETECTOR, RobotType::VACUUM, RobotType::WASHER}) {
+        const auto idx = static_cast<std::size_t>(type);
+        const double robotTicks = static_cast<double>(reg_.ofType(type).size()) * static_cast<double>(stats_.makespan);
+        stats_.utilization[idx] = robotTicks > 0 ? static_cast<double>(busyTicks[idx]) / robotTicks : 0.0;
+    }
+    stats_.meanQueueWait = stats_.tasksDispatched > 0
+        ? static_cast<double>(totalQueueWait_) / static_cast<double>(stats_.tasksDispatched) : 0.0;
+
+    // percentages and the mean wait in tenths, the logger only formats integers
+    auto tenths = [](double v) { return static_cast<long long>(v * 10.0 + 0.5); };
+    const long long det = tenths(stats_.utilization[0] * 100.0);
+    const long long vac = tenths(stats_.utilization[1] * 100.0);
+    const long long wash = tenths(stats_.utilization[2] * 100.0);
+    const long long wait = tenths(stats_.meanQueueWait);
+    LOG_INFO("[Sim] makespan ", stats_.makespan, " ticks | utilization detector ", det / 10, ".", det % 10,
+             "% vacuum ", vac / 10, ".", vac % 10, "% washer ", wash / 10, ".", wash % 10,
+             "% | queue wait mean ", wait / 10, ".", wait % 10, " max ", stats_.maxQueueWait,
+             " ticks over ", stats_.tasksDispatched, " tasks");
+}
+
+//////////////////// The Main Loop (PIPELINED):
+//
+// detection (this thread) --vacuum channel--> vacuum stage --washer channel--> washer stage
+//
+// Each stage commands only the robots of its own type and drains their events from a stage bus,
+// so robot objects, pending tasks and idle indexes are never shared between threads; the map is
+// the only state the stages touch concurrently. Detector regions are disjoint and every cell is
+// vacuumed once, so the channels need no de-duplication.
+
+void ControlUnit::runPipelined(std::vector<DetectorState>& detectors) {
+    TaskChannel<Position> vacuumChannel;
+    TaskChannel<Position> washerChannel;
+    std::array<std::unique_ptr<Bus>, 3> stageBuses;
+    for (RobotType type : {RobotType::DETECTOR, RobotType::VACUUM, RobotType::WASHER}) {
+        const auto idx = static_cast<std::size_t>(type);
+        stageBuses[idx] = std::make_unique<Bus>(reg_, type);
+        eventSource_[idx] = stageBuses[idx].get();
+    }
+    vacuumChannel_ = &vacuumChannel;
+    washerChannel_ = &washerChannel;
+
+    std::thread vacuumStage([&] { runDispatchStage(RobotType::VACUUM, vacuumChannel, &washerChannel); });
+    std::thread washerStage([&] { runDispatchStage(RobotType::WASHER, washerChannel, nullptr); });
+
+    // detection stage
+    while (processDetectors(detectors)) {
+    }
+    vacuumChannel.close();
+
+    vacuumStage.join();
+    washerStage.join();
+
+    // hand the robots back to the main bus
+    vacuumChannel_ = nullptr;
+    washerChannel_ = nullptr;
+    eventSource_.fill(&bus_);
+    for (RobotBase* robot : reg_.all()) {
+        bus_.attach(*robot);
+    }
+}
+
+void ControlUnit::runDispatchStage(RobotType type, TaskChannel<Position>& input, TaskChannel<Position>* output) {
+    const bool vacuum = type == RobotType::VACUUM;
+    std::queue<QueuedCell>& queue = vacuum ? vacuumQueue_ : washerQueue_;
+    CellSet& queued = vacuum ? queuedForVacuum_ : queuedForWasher_;
+
+    Position target;
+    while (true) {
+        // wait for work only when the local queue is empty, otherwise take what has arrived
+        if (queue.empty()) {
+            if (!input.pop(target)) {
+                break;   // upstream finished and everything was dispatched
+            }
+            if (queueTask(queue, queued, target)) {
+                recordQueued(type, queue.back(), queue.size());
+            }
+        }
+        while (input.tryPop(target)) {
+            if (queueTask(queue, queued, target)) {
+                recordQueued(type, queue.back(), queue.size());
+            }
+        }
+
+        const bool progress = vacuum ? processVacuumQueue() : processWasherQueue();
+        if (!progress && !queue.empty()) {
+            // robots finish synchronously, so a stuck queue means no robot of this type can serve it
+            LOG_ERROR("[CU] no ", (vacuum ? "vacuum" : "washer"), " robot available for ", queue.size(),
+                      " queued cells");
+            while (input.pop(target)) {
+            }
             break;
         }
     }
+
+    if (output) {
+        output->close();
+    }
 }
 
 bool ControlUnit::processVacuumQueue() {
+    if (policy_ == AssignmentPolicy::BATCH) {
+        return processQueueBatch(RobotType::VACUUM, vacuumQueue_, queuedForVacuum_, &EnvironmentMap::hasDirt, WorkKind::VACUUM);
+    }
     bool processed = false;
     // Try to assign tasks to idle vacuum robots
     while (!vacuumQueue_.empty()) {
-        Position target = vacuumQueue_.front();
+        const QueuedCell task = vacuumQueue_.front();
+        const Position target = task.pos;
         // Check if Dirty - maybe already vacuumed
         if (!map_.hasDirt(target)) {
-            queuedForVacuum_.erase(cellKey(target));
+            queuedForVacuum_.erase(target);
             vacuumQueue_.pop();
             continue;
         }
@@ -302,11 +807,9 @@ bool ControlUnit::processVacuumQueue() {
         }
         // Remove from queue
         vacuumQueue_.pop();
-        queuedForVacuum_.erase(cellKey(target));
+        queuedForVacuum_.erase(target);
         // Assign task and send command
-        pendingTasks_[robot->id()] = PendingTask{"VACUUM", target};
-        sendMoveCmd(robot->id(), target);
-        drainEvents();
+        dispatchTask(*robot, WorkKind::VACUUM, task);
 
         processed = true;
     }
@@ -315,13 +818,17 @@ bool ControlUnit::processVacuumQueue() {
 }
 
 bool ControlUnit::processWasherQueue() {
+    if (policy_ == AssignmentPolicy::BATCH) {
+        return processQueueBatch(RobotType::WASHER, washerQueue_, queuedForWasher_, &EnvironmentMap::needsWash, WorkKind::WASH);
+    }
     bool processed = false;
 
     while (!washerQueue_.empty()) {
-        Position target = washerQueue_.front();
+        const QueuedCell task = washerQueue_.front();
+        const Position target = task.pos;
         // Check if Dirty - maybe already washed
         if (!map_.needsWash(target)) {
-            queuedForWasher_.erase(cellKey(target));
+            queuedForWasher_.erase(target);
             washerQueue_.pop();
             continue;
         }
@@ -333,11 +840,9 @@ bool ControlUnit::processWasherQueue() {
         }
         // Remove from queue
         washerQueue_.pop();
-        queuedForWasher_.erase(cellKey(target));
+        queuedForWasher_.erase(target);
         // Assign task and send command
-        pendingTasks_[robot->id()] = PendingTask{"WASH", target};
-        sendMoveCmd(robot->id(), target);
-        drainEvents();
+        dispatchTask(*robot, WorkKind::WASH, task);
 
         processed = true;
     }
@@ -345,37 +850,185 @@ bool ControlUnit::processWasherQueue() {
     return processed;
 }
 
+bool ControlUnit::processQueueBatch(RobotType type, std::queue<QueuedCell>& queue, CellSet& queued,
+                                    bool (EnvironmentMap::*stillNeeded)(Position) const, WorkKind kind) {
+    bool processed = false;
+
+    // each round matches the current queue against the currently idle robots
+    while (!queue.empty()) {
+        // collect the assignable robots first (sorted by id so that rounds are deterministic);
+        // without any the queue stays as it is
+        if (idleIndexFor(type).size() == 0) {
+            break;
+        }
+        std::vector<RobotBase*> robots;
+        const FleetState& fleet = reg_.fleet();
+        idleIndexFor(type).forEach([&](RobotId id, Position) {
+            const std::size_t slot = fleet.slotOf(id);
+            if (slot != FleetState::kNoSlot && fleet.state(slot) == RobotState::IDLE && !hasPendingTask(type, id)) {
+                robots.push_back(reg_.all()[slot]);
+            }
+        });
+        if (robots.empty()) {
+            break;
+        }
+        std::sort(robots.begin(), robots.end(), [](const auto& a, const auto& b) { return a->id() < b->id(); });
+        std::vector<Position> robotPositions;
+        robotPositions.reserve(robots.size());
+        for (const auto& robot : robots) {
+            robotPositions.push_back(robot->position());
+        }
+
+        // take every queued target that still needs work
+        std::vector<QueuedCell> tasks;
+        std::vector<Position> targets;
+        tasks.reserve(queue.size());
+        targets.reserve(queue.size());
+        while (!queue.empty()) {
+            const QueuedCell task = queue.front();
+            queue.pop();
+            if ((map_.*stillNeeded)(task.pos)) {
+                tasks.push_back(task);
+                targets.push_back(task.pos);
+            } else {
+                queued.erase(task.pos);
+            }
+        }
+
+        const std::vector<Assignment> assignments = assignTargets(robotPositions, targets);
+
+        // targets left without a robot go back to the queue in their original order
+        std::vector<bool> assigned(targets.size(), false);
+        for (const auto& a : assignments) {
+            assigned[a.target] = true;
+        }
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            if (!assigned[i]) {
+                queue.push(tasks[i]);
+            }
+        }
+        if (assignments.empty()) {
+            break;
+        }
+
+        for (const auto& a : assignments) {
+            queued.erase(targets[a.target]);
+            dispatchTask(*robots[a.robot], kind, tasks[a.target]);
+        }
+        processed = true;
+    }
+
+    return processed;
+}
+
+void ControlUnit::dispatchTask(RobotBase& robot, WorkKind kind, const QueuedCell& task) {
+    const Position target = task.pos;
+    noteDispatched(task);
+    recordDispatch(robot.type(), task);
+    pendingFor(robot.type())[robot.id()] = PendingTask{kind, target};
+    idleIndexFor(robot.type()).remove(robot.id());
+    travelDistance_.fetch_add(manhattan(robot.position(), target), std::memory_order_relaxed);
+    sendMoveCmd(robot.id(), target);
+    drainEventsOf(robot.type());
+}
+
 // enqueue a CELL for vacuuming to the vacuumQueue_ 
 bool ControlUnit::enqueueVacuumTask(Position pos) {
     if (!map_.hasDirt(pos)) {
         return false;
     }
-    if (queuedForVacuum_.insert(cellKey(pos)).second) {
-        vacuumQueue_.push(pos);
+    if (vacuumChannel_) {   // pipelined: the vacuum stage owns the queue
+        vacuumChannel_->push(pos);
+        return true;
+    }
+    if (!queueTask(vacuumQueue_, queuedForVacuum_, pos)) {
+        return false;
+    }
+    recordQueued(RobotType::VACUUM, vacuumQueue_.back(), vacuumQueue_.size());
+    return true;
+}
+
+// enqueue a freshly vacuumed CELL for washing
+void ControlUnit::enqueueWasherTask(Position pos) {
+    if (washerChannel_) {   // pipelined: the washer stage owns the queue
+        washerChannel_->push(pos);
+        return;
+    }
+    if (queueTask(washerQueue_, queuedForWasher_, pos)) {
+        recordQueued(RobotType::WASHER, washerQueue_.back(), washerQueue_.size());
+    }
+}
+
+bool ControlUnit::queueTask(std::queue<QueuedCell>& queue, CellSet& queued, Position pos) {
+    if (queued.insert(pos)) {
+        queue.push(QueuedCell{pos, now_});
         return true;
     }
     return false;
 }
 
 // find the nearest idle robot of the given type to the target position
-std::shared_ptr<RobotBase> ControlUnit::findNearestIdleRobot(RobotType type, Position target) const {
-    auto robots = reg_.getByType(type);
-    std::shared_ptr<RobotBase> best;
-    int bestDistance = std::numeric_limits<int>::max();
-    // search among idle robots without pending tasks - use distance method to find the nearest one
-    for (const auto& robot : robots) {
-        if (robot->state() != RobotState::IDLE) {
-            continue;
+RobotBase* ControlUnit::findNearestIdleRobot(RobotType type, Position target) {
+    const std::uint64_t start = kMetricsEnabled ? RunMetrics::nowNs() : 0;
+    IdleRobotIndex& index = idleIndexFor(type);
+    RobotId id = 0;
+    RobotBase* nearest = nullptr;
+    // the index follows StatusEvents; drop entries whose robot is no longer assignable and retry
+    const FleetState& fleet = reg_.fleet();
+    auto lookup = [&](RobotId& out) {
+        switch (index.findNearby(target, out)) {
+            case IdleRobotIndex::Lookup::FOUND:      return true;
+            case IdleRobotIndex::Lookup::EMPTY:      return false;
+            case IdleRobotIndex::Lookup::TOO_SPARSE: break;
+        }
+        // sparse idle robots: one vectorized pass over the fleet columns (ties go to the lowest
+        // slot). It reads every robot's state, so pipelined stage threads use the index pass instead.
+        if (vacuumChannel_ == nullptr && fleet.nearestIdle(type, target, out) && index.contains(out)) {
+            return true;
+        }
+        return index.nearestByScan(target, out);
+    };
+    while (lookup(id)) {
+        const std::size_t slot = fleet.slotOf(id);
+        if (slot != FleetState::kNoSlot && fleet.state(slot) == RobotState::IDLE && !hasPendingTask(type, id)) {
+            nearest = reg_.all()[slot];
+            break;
+        }
+        index.remove(id);
+    }
+    if constexpr (kMetricsEnabled) {
+        if (metrics_) {
+            metrics_->nearestIdleCost[static_cast<std::size_t>(type)].record(RunMetrics::nowNs() - start);
         }
-        if (pendingTasks_.count(robot->id()) > 0) {
+    }
+    return nearest;
+}
+
+// seed the idle index from the fleet state table (called when a run starts)
+void ControlUnit::rebuildIdleIndex() {
+    for (auto& index : idleIndex_) {
+        index.clear();
+    }
+    const FleetState& fleet = reg_.fleet();
+    for (std::size_t slot = 0; slot < fleet.size(); ++slot) {
+        const RobotType type = fleet.type(slot);
+        if (type == RobotType::DETECTOR || fleet.state(slot) != RobotState::IDLE) {
             continue;
         }
-        const int dist = distance(robot->position(), target);
-        if (dist < bestDistance) {
-            bestDistance = dist;
-            best = robot;
+        if (!hasPendingTask(type, fleet.id(slot))) {
+            idleIndexFor(type).insert(fleet.id(slot), fleet.position(slot));
         }
     }
+}
 
-    return best;
+void ControlUnit::updateIdleIndex(const StatusEvent& event) {
+    if (event.type == RobotType::DETECTOR) {
+        return;   // detectors follow scan plans, they are never assigned through the index
+    }
+    IdleRobotIndex& index = idleIndexFor(event.type);
+    if (event.state == RobotState::IDLE && !hasPendingTask(event.type, event.from)) {
+        index.insert(event.from, event.position);
+    } else {
+        index.remove(event.from);
+    }
 }
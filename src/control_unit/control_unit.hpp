@@ -1,45 +1,193 @@
 #pragma once
+#include <array>
+#include <functional>
+#include <atomic>
+#include <memory>
 #include <queue>
-#include <set>
 #include <unordered_map>
 #include <utility>
 #include <string>
+#include <vector>
 #include "registry/registry.hpp"
 #include "environment/environment_map.hpp"
 #include "planner/planner.hpp"
 #include "common/bootstrap.hpp"
+#include "common/idle_robot_index.hpp"
 #include "bus/bus.hpp"
+#include "control_unit/cell_set.hpp"
+#include "control_unit/checkpoint.hpp"
+#include "control_unit/run_metrics.hpp"
+#include "control_unit/task_channel.hpp"
+
+// How queued targets are matched to idle robots.
+enum class AssignmentPolicy {
+    GREEDY,  // the queue front takes the nearest idle robot, one target at a time
+    BATCH    // all queued targets vs. all idle robots of the type, min-total-distance matching
+};
+
+// How run() drives the fleet.
+enum class ExecutionMode {
+    SERIAL,     // one thread alternates detection, vacuum dispatch and washer dispatch
+    PIPELINED   // one thread per robot type, stages connected by task channels
+};
+
+// How robot actions relate to time.
+enum class SimulationMode {
+    INSTANT,       // robots move and work synchronously, no notion of time
+    TIME_STEPPED,  // robots get a RobotTiming and the CU advances a tick clock with TickCommands
+    EVENT_DRIVEN   // timed like TIME_STEPPED, but the clock jumps straight to the next robot completion
+};
+
+// Scheduling quality of the last timed run().
+struct SimulationStats {
+    unsigned long long makespan{0};         // ticks from the start of the run until all work was done
+    std::array<double, 3> utilization{};    // per RobotType: share of robot-ticks spent MOVING or WORKING
+    std::size_t tasksDispatched{0};         // vacuum and wash tasks handed to robots
+    double meanQueueWait{0.0};              // ticks a cell waited in a queue before being dispatched
+    unsigned long long maxQueueWait{0};
+};
 
 class ControlUnit {
 public:
-    ControlUnit(RobotRegistry& reg, EnvironmentMap& map): reg_(reg), map_(map), bus_(reg) {}
+    ControlUnit(RobotRegistry& reg, EnvironmentMap& map): reg_(reg), map_(map), bus_(reg) {
+        eventSource_.fill(&bus_);
+    }
+
+    // task assignment policy for the vacuum and washer queues (GREEDY by default)
+    void setAssignmentPolicy(AssignmentPolicy policy) { policy_ = policy; }
+    // serial or pipelined run loop (SERIAL by default)
+    void setExecutionMode(ExecutionMode mode) { mode_ = mode; }
+    // instant or time-stepped robots (INSTANT by default); PIPELINED execution needs INSTANT
+    void setSimulationMode(SimulationMode mode) { simMode_ = mode; }
+    // timing given to every robot of a type when a timed run() starts
+    void setRobotTiming(RobotType type, RobotTiming timing) { timing_[static_cast<std::size_t>(type)] = timing; }
+    // makespan, utilization and queue waits of the last timed run()
+    const SimulationStats& simulationStats() const { return stats_; }
+    // counters and latency histograms of the last run() (nullptr when built with CU_METRICS=0)
+    const RunMetrics* runMetrics() const { return metrics_.get(); }
+    // total Manhattan distance robots were sent to travel during the last run()
+    long long travelDistance() const { return travelDistance_.load(std::memory_order_relaxed); }
 
     // not in use yet
     void printRobots() const;
     // bootstrap the environment map with size and dirt spots
     void seedFrom(const BootstrapFeed& feed);
+    // bootstrap from a binary feed file (environment/feed_file.hpp), streamed straight into the map
+    bool seedFromFile(const std::string& path, const std::vector<std::string>& scanPatterns = {"serpentine"});
+    // write a snapshot (control_unit/checkpoint.hpp) to `path` every `everyRounds` rounds of the run
+    // loop and when the run ends; 0 turns checkpointing off. PIPELINED runs write no snapshots.
+    void setCheckpoint(const std::string& path, std::size_t everyRounds);
+    // instead of seedFrom: load the map and planner from a snapshot; the next run() re-queues the
+    // snapshot's tasks and resumes each detector where it stopped (with the same number of detectors)
+    bool restoreFrom(const std::string& path);
     // main control loop
     void run();
+    // take a robot out of the fleet once this control unit exists: unsubscribes it from the bus and
+    // forgets its idle-index entry and pending task before RobotRegistry::remove drops it (and its
+    // FleetState row). Call this instead of RobotRegistry::remove. False if the id is unknown.
+    bool removeRobot(RobotId id);
 
 private:
+    // Bookkeeping block that packages each detector's scan state
+    struct DetectorState {
+        RobotBase* robot;
+        ScanPath                   path;
+        bool                       started{false};
+        bool                       finished{false};
+        bool                       scanPending{false};   // timed robots: scan scanTarget once arrived
+        Position                   scanTarget{};
+    };
+
+    // a cell waiting in the vacuum or washer queue, with the tick it was queued at and, when run
+    // metrics are on, the wall-clock time (RunMetrics::nowNs)
+    struct QueuedCell {
+        Position           pos;
+        unsigned long long queuedTick{0};
+        std::uint64_t      queuedNs{0};
+    };
+
     // command sending helpers  
     void sendMoveCmd(RobotId id, Position dst);
-    void sendStartRobotWorkCmd(RobotId id, const std::string& kind);
+    void sendStartRobotWorkCmd(RobotId id, WorkKind kind);
     void sendStopRobotCmd(RobotId id);
-    // event retrieval - called by the control unit to process robot reports
+    // event retrieval - drains every event on the main bus (the serial loops and run() setup)
     void drainEvents();
+    // drains the events of robots of the given type from the bus that carries them: their stage bus
+    // while pipelined, otherwise the main bus, which hands out the events of every type
+    void drainEventsOf(RobotType type);
+    void drainBus(Bus& source, std::vector<Bus::EventVariant>& batch);
     // event handling helpers
-    void handleEvent(const Bus::EventVariant& event);
+    void handleEventRun(const std::vector<Bus::EventVariant>& batch, std::size_t begin, std::size_t end);
     void handleStatusEvent(const StatusEvent& event);
     void handleWorkCompletedEvent(const WorkCompletedEvent& event);
 
+    // run loops
+    void runSerial(std::vector<DetectorState>& detectors);
+    void runPipelined(std::vector<DetectorState>& detectors);
+    void runTimeStepped(std::vector<DetectorState>& detectors);
+    void runEventDriven(std::vector<DetectorState>& detectors);
+    // pipeline stage body: feed the local queue from `input`, dispatch it, close `output` when done
+    void runDispatchStage(RobotType type, TaskChannel<Position>& input, TaskChannel<Position>* output);
+
+    // advance every detector one step along its path
+    bool processDetectors(std::vector<DetectorState>& detectors);
+    // check the cell a detector stands on and queue it for vacuuming if dirty
+    void scanCell(const DetectorState& state, Position cell);
     // task processing helpers
     bool processVacuumQueue();
     bool processWasherQueue();
+    // BATCH policy: match every queued target that still needs work against every idle robot
+    bool processQueueBatch(RobotType type, std::queue<QueuedCell>& queue, CellSet& queued,
+                           bool (EnvironmentMap::*stillNeeded)(Position) const, WorkKind kind);
+    // record the task for the robot and send it on its way
+    void dispatchTask(RobotBase& robot, WorkKind kind, const QueuedCell& task);
     // enqueue a CELL for vacuuming to the vacuumQueue_(the enqueue for washer is done internally after vacuum)
     bool enqueueVacuumTask(Position pos);
+    void enqueueWasherTask(Position pos);
+    // add a cell to a local queue unless it is already queued, stamped with the current tick
+    bool queueTask(std::queue<QueuedCell>& queue, CellSet& queued, Position pos);
     // find the nearest idle robot of the given type to the target position
-    std::shared_ptr<RobotBase> findNearestIdleRobot(RobotType type, Position target) const;
+    RobotBase* findNearestIdleRobot(RobotType type, Position target);
+    // idle-robot index maintenance - robots are indexed while IDLE and without a pending task
+    IdleRobotIndex& idleIndexFor(RobotType type) { return idleIndex_[static_cast<std::size_t>(type)]; }
+    void rebuildIdleIndex();
+    void updateIdleIndex(const StatusEvent& event);
+    // timed runs: count the robots of each type that are MOVING or WORKING (and collect their ids
+    // into `ids` if given); true if any is
+    bool countBusyRobots(std::array<std::size_t, 3>& busy, std::vector<RobotId>* ids = nullptr) const;
+    // timed runs: send TickCommands for now_ to `robots`, draining their events after every batch
+    // so that the replies of one batch always fit the event ring
+    void tickRobots(const std::vector<RobotId>& robots);
+    // timed runs: bring a robot's clock up to now_ before commanding it (only robots with work in
+    // flight are ticked); EVENT_DRIVEN: schedule the completion of whatever a StatusEvent says it started
+    void syncClock(RobotId id);
+    void scheduleWake(const StatusEvent& event);
+    // timed runs: account the ticks a dispatched cell waited in its queue
+    void noteDispatched(const QueuedCell& task);
+    void reportSimulation(unsigned long long start, const std::array<unsigned long long, 3>& busyTicks);
+    // metrics hooks, compiled out with CU_METRICS=0
+    void recordCommand();
+    void recordEvents(std::size_t count);
+    void recordQueued(RobotType type, QueuedCell& cell, std::size_t depth);
+    void recordDispatch(RobotType type, const QueuedCell& cell);
+    // checkpointing: count a round of the run loop and snapshot when due / unconditionally
+    void checkpointRound(const std::vector<DetectorState>& detectors);
+    void writeCheckpointNow(const std::vector<DetectorState>& detectors);
+    // re-queue the tasks of a restored snapshot and move its detectors along their paths
+    void resumeRestored(std::vector<DetectorState>& detectors);
+
+    // store inside pendingTasks_ map for tracking which job is still pending to be done
+    struct PendingTask {
+        WorkKind    kind;
+        Position    target;
+    };
+    // pending tasks are kept per robot type so that pipeline stages never share a map
+    std::unordered_map<RobotId, PendingTask>& pendingFor(RobotType type) {
+        return pendingTasks_[static_cast<std::size_t>(type)];
+    }
+    bool hasPendingTask(RobotType type, RobotId id) const {
+        return pendingTasks_[static_cast<std::size_t>(type)].count(id) > 0;
+    }
 
     // members - the core components
     RobotRegistry& reg_;
@@ -47,18 +195,54 @@ private:
     Planner        planner_;
     Bus            bus_;
 
-    // store inside pendingTasks_ map for tracking which job is still pending to be done
-    struct PendingTask {
-        std::string kind;
-        Position    target;
+    // task queues and bookkeeping
+    std::queue<QueuedCell> vacuumQueue_;
+    std::queue<QueuedCell> washerQueue_;
+    // to avoid duplicate entries of the same cell (sized to the map when a run starts)
+    CellSet queuedForVacuum_;
+    CellSet queuedForWasher_;
+    // to know which task is pending for which robot, one map per RobotType
+    std::array<std::unordered_map<RobotId, PendingTask>, 3> pendingTasks_;
+    AssignmentPolicy policy_{AssignmentPolicy::GREEDY};
+    ExecutionMode    mode_{ExecutionMode::SERIAL};
+    std::atomic<long long> travelDistance_{0};
+    // simulated time (TIME_STEPPED): the tick clock, per-type timings and the last run's statistics
+    SimulationMode simMode_{SimulationMode::INSTANT};
+    std::array<RobotTiming, 3> timing_{{RobotTiming{2, 0}, RobotTiming{1, 3}, RobotTiming{1, 5}}};
+    unsigned long long now_{0};
+    SimulationStats stats_{};
+    unsigned long long totalQueueWait_{0};
+    // EVENT_DRIVEN: pending robot completions, earliest first (same tick: lowest id first),
+    // and the robot-ticks each type has been scheduled busy for
+    struct Wake {
+        unsigned long long at;
+        RobotId            robot;
+        bool operator>(const Wake& other) const {
+            return at != other.at ? at > other.at : robot > other.robot;
+        }
     };
+    std::priority_queue<Wake, std::vector<Wake>, std::greater<Wake>> wakeups_;
+    std::array<unsigned long long, 3> scheduledBusy_{};
+    // robots ticked at the current tick (reused buffer)
+    std::vector<RobotId> ticking_;
+    // checkpointing (setCheckpoint) and the snapshot waiting to be resumed by run() (restoreFrom)
+    std::string     checkpointPath_;
+    std::size_t     checkpointEvery_{0};
+    std::size_t     roundsSinceCheckpoint_{0};
+    CheckpointState restored_;
+    bool            restorePending_{false};
+    // instrumentation of the current / last run(), created by run() when metrics are compiled in
+    std::unique_ptr<RunMetrics> metrics_;
+    // spatial index of assignable robots, one per RobotType, kept current from StatusEvents
+    std::array<IdleRobotIndex, 3> idleIndex_;
 
-    // task queues and bookkeeping
-    std::queue<Position> vacuumQueue_;
-    std::queue<Position> washerQueue_;
-    // to avoid duplicate entries of the same cell
-    std::set<std::pair<int,int>> queuedForVacuum_;
-    std::set<std::pair<int,int>> queuedForWasher_;
-    // to know which task is pending for which robot
-    std::unordered_map<RobotId, PendingTask> pendingTasks_;
+    // where the events of each robot type are drained from (the main bus, or a stage bus while pipelined)
+    std::array<Bus*, 3> eventSource_{};
+    // PIPELINED only: channels feeding the vacuum and washer stages (nullptr otherwise)
+    TaskChannel<Position>* vacuumChannel_{nullptr};
+    TaskChannel<Position>* washerChannel_{nullptr};
+
+    // reusable buffers for batched event draining, one per RobotType
+    static constexpr std::size_t kEventBatchSize = 256;
+    std::array<std::vector<Bus::EventVariant>, 3> eventBatch_;
 };
@@ -0,0 +1,67 @@
+#include "control_unit/run_metrics.hpp"
+
+#include <cmath>
+
+#include "common/types.hpp"
+#include "logging/log.hpp"
+
+void LatencyHistogram::reset() {
+    counts_.fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = ~std::uint64_t{0};
+    max_ = 0;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket) {
+    if (bucket < (std::size_t{1} << kSubBits)) {
+        return bucket;
+    }
+    const unsigned exponent = static_cast<unsigned>(bucket >> kSubBits) + kSubBits - 1;
+    const std::uint64_t sub = bucket & ((std::size_t{1} << kSubBits) - 1);
+    const unsigned shift = exponent - kSubBits;
+    const std::uint64_t lower = ((std::uint64_t{1} << kSubBits) + sub) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+std::uint64_t LatencyHistogram::percentile(double percent) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    const double clamped = percent < 0.0 ? 0.0 : (percent > 100.0 ? 100.0 : percent);
+    auto rank = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count_)));
+    rank = rank == 0 ? 1 : rank;
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+        seen += counts_[bucket];
+        if (seen >= rank) {
+            const std::uint64_t bound = bucketUpperBound(bucket);
+            return bound < max_ ? bound : max_;
+        }
+    }
+    return max_;
+}
+
+// ---- helper functions inside anonymous namespace ----
+namespace {
+void dumpHistogram(const char* name, const LatencyHistogram& h) {
+    if (h.count() == 0) {
+        return;
+    }
+    LOG_INFO("[Metrics] ", name, ": n=", h.count(), " min=", h.min(), " p50=", h.percentile(50.0),
+             " p90=", h.percentile(90.0), " p99=", h.percentile(99.0), " max=", h.max(), " mean=", h.mean(), " ns");
+}
+}
+
+void RunMetrics::dump() const {
+    const auto vacuum = static_cast<std::size_t>(RobotType::VACUUM);
+    const auto washer = static_cast<std::size_t>(RobotType::WASHER);
+    LOG_INFO("[Metrics] commands sent ", commandsSent.load(std::memory_order_relaxed),
+             " | events drained ", eventsDrained.load(std::memory_order_relaxed),
+             " | queued vacuum ", tasksQueued[vacuum], " washer ", tasksQueued[washer],
+             " | max queue depth vacuum ", maxQueueDepth[vacuum], " washer ", maxQueueDepth[washer]);
+    dumpHistogram("detection -> vacuum dispatch", queueLatency[vacuum]);
+    dumpHistogram("vacuum done -> wash dispatch", queueLatency[washer]);
+    dumpHistogram("findNearestIdleRobot (vacuum)", nearestIdleCost[vacuum]);
+    dumpHistogram("findNearestIdleRobot (washer)", nearestIdleCost[washer]);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Instrumentation of ControlUnit::run: counters and latency histograms, dumped at the end of the run.
+// Building with -DCU_METRICS=0 (make METRICS=0) compiles every recording site out of the control unit.
+
+#ifndef CU_METRICS
+#define CU_METRICS 1
+#endif
+
+inline constexpr bool kMetricsEnabled = CU_METRICS != 0;
+
+// HDR-style histogram of non-negative integer samples. Values below 2^kSubBits get one bucket each;
+// above that, every power of two is split into 2^kSubBits linear buckets, so any recorded value is
+// reported within 1/2^kSubBits (6.25%) of its true value, from nanoseconds up to 2^64.
+// Recording is a couple of bit operations and one increment; there is no allocation.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 4;
+    static constexpr std::size_t kBuckets = (64 - kSubBits + 1) << kSubBits;
+
+    void record(std::uint64_t value) {
+        ++counts_[bucketOf(value)];
+        ++count_;
+        sum_ += value;
+        min_ = value < min_ ? value : min_;
+        max_ = value > max_ ? value : max_;
+    }
+    void reset();
+
+    std::uint64_t count() const { return count_; }
+    std::uint64_t min() const { return count_ ? min_ : 0; }
+    std::uint64_t max() const { return max_; }
+    std::uint64_t mean() const { return count_ ? sum_ / count_ : 0; }
+    // smallest bucket bound that `percent` percent of the samples do not exceed (0 if empty)
+    std::uint64_t percentile(double percent) const;
+
+private:
+    static std::size_t bucketOf(std::uint64_t value) {
+        if (value < (std::uint64_t{1} << kSubBits)) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        const auto sub = static_cast<std::size_t>((value >> (exponent - kSubBits)) & ((1u << kSubBits) - 1));
+        return (static_cast<std::size_t>(exponent - kSubBits + 1) << kSubBits) + sub;
+    }
+    static std::uint64_t bucketUpperBound(std::size_t bucket);
+
+    std::array<std::uint64_t, kBuckets> counts_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t min_{~std::uint64_t{0}};
+    std::uint64_t max_{0};
+};
+
+// Everything one run() records. Per-RobotType entries are only touched by the stage that owns the
+// type, so PIPELINED stages never share them; the counters are shared and therefore atomic.
+struct RunMetrics {
+    static std::uint64_t nowNs() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::atomic<std::uint64_t> commandsSent{0};
+    std::atomic<std::uint64_t> eventsDrained{0};
+    std::array<std::uint64_t, 3> tasksQueued{};    // per RobotType: cells that entered its task queue
+    std::array<std::size_t, 3>   maxQueueDepth{};  // per RobotType: deepest its task queue got
+    // per RobotType, ns from a cell entering the type's queue to a robot being dispatched to it:
+    // VACUUM measures detection -> vacuum dispatch, WASHER vacuum completion -> wash dispatch
+    // (the enqueue time travels with the queue entry, see ControlUnit::QueuedCell)
+    std::array<LatencyHistogram, 3> queueLatency;
+    // per RobotType, ns spent in each findNearestIdleRobot call
+    std::array<LatencyHistogram, 3> nearestIdleCost;
+
+    // write a summary through LOG_INFO
+    void dump() const;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+// Thread-safe FIFO connecting two pipeline stages. The producer closes the channel when it
+// has nothing more to send; the consumer drains what is left and then sees pop() fail.
+template<typename T>
+class TaskChannel {
+public:
+    void push(T item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            items_.push_back(std::move(item));
+        }
+        ready_.notify_one();
+    }
+
+    // block until an item is available (true) or the channel is closed and empty (false)
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        out = std::move(items_.front());
+        items_.pop_front();
+        return true;
+    }
+
+    // non-blocking variant of pop()
+    bool tryPop(T& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        out = std::move(items_.front());
+        items_.pop_front();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        ready_.notify_all();
+    }
+
+private:
+    std::mutex              mutex_;
+    std::condition_variable ready_;
+    std::deque<T>           items_;
+    bool                    closed_{false};
+};
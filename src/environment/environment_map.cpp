@@ -1,8 +1,22 @@
 #include "environment/environment_map.hpp"
 
 #include <iostream>
+#include <mutex>
 
-bool EnvironmentMap::initializeGrid(int width, int height, const std::vector<Position>& dirtSpots) {
+bool EnvironmentMap::initializeGrid(int width, int height, const std::vector<Position>& dirtSpots,
+                                    MapStorage storage) {
+    if (!resetGrid(width, height, storage, dirtSpots.size())) {
+        return false;
+    }
+    for (const auto& spot : dirtSpots) {
+        if (!addDirt(spot)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EnvironmentMap::resetGrid(int width, int height, MapStorage storage, std::size_t expectedDirt) {
     if (width <= 0 || height <= 0) {
         std::cerr << "[Map] grid dimensions must be positive (" << width << "x" << height << ")\n";
         return false;
@@ -10,58 +24,148 @@ bool EnvironmentMap::initializeGrid(int width, int height, const std::vector<Pos
 
     width_ = width;
     height_ = height;
-    grid_.assign(height_, std::vector<CellState>(width_, CellState::CLEAN));
-
-    for (const auto& spot : dirtSpots) {
-        if (!inBounds(spot)) {
-            std::cerr << "[Map] dirt spot out of bounds at (" << spot.x << "," << spot.y << ")\n";
-            grid_.clear();
-            width_ = height_ = 0;
-            return false;
-        }
-        grid_[spot.y][spot.x] = CellState::DIRTY;
+    storage_ = storage;
+    resetCells(0);
+    sparse_.clear();
+    if (storage_ == MapStorage::DENSE) {
+        resetCells((cellCount() + kCellsPerWord - 1) / kCellsPerWord);   // all CLEAN
+    } else {
+        sparse_.reserve(expectedDirt);
     }
     return true;
 }
 
-bool EnvironmentMap::hasDirt(Position p) const {
-    if (!inBounds(p) || grid_.empty()) {
+bool EnvironmentMap::addDirt(Position p) {
+    if (!inBounds(p)) {
+        std::cerr << "[Map] dirt spot out of bounds at (" << p.x << "," << p.y << ")\n";
+        discardGrid();
         return false;
     }
-    return grid_[p.y][p.x] == CellState::DIRTY;
+    markCell(indexOf(p), CellState::DIRTY);
+    return true;
 }
 
-bool EnvironmentMap::markVacuumed(Position p) {
-    if (!inBounds(p) || grid_.empty()) {
+bool EnvironmentMap::addDirt(std::uint64_t cellIndex) {
+    return addCell(cellIndex, CellState::DIRTY);
+}
+
+bool EnvironmentMap::addCell(std::uint64_t cellIndex, CellState state) {
+    if (cellIndex >= cellCount()) {
+        std::cerr << "[Map] cell index " << cellIndex << " out of bounds\n";
+        discardGrid();
         return false;
     }
-    CellState& cell = grid_[p.y][p.x];
-    if (cell != CellState::DIRTY) {
-        return false;
+    if (state != CellState::CLEAN) {
+        markCell(static_cast<std::size_t>(cellIndex), state);
     }
-    cell = CellState::VACUUMED;
     return true;
 }
 
+void EnvironmentMap::discardGrid() {
+    resetCells(0);
+    sparse_.clear();
+    width_ = height_ = 0;
+}
+
+bool EnvironmentMap::hasDirt(Position p) const {
+    return cellAt(p) == CellState::DIRTY;
+}
+
+bool EnvironmentMap::markVacuumed(Position p) {
+    return transition(p, CellState::DIRTY, CellState::VACUUMED);
+}
+
 bool EnvironmentMap::needsWash(Position p) const {
-    if (!inBounds(p) || grid_.empty()) {
-        return false;
-    }
-    return grid_[p.y][p.x] == CellState::VACUUMED;
+    return cellAt(p) == CellState::VACUUMED;
 }
 
 bool EnvironmentMap::markWashed(Position p) {
-    if (!inBounds(p) || grid_.empty()) {
-        return false;
-    }
-    CellState& cell = grid_[p.y][p.x];
-    if (cell != CellState::VACUUMED) {
-        return false;
-    }
-    cell = CellState::CLEAN;
-    return true;
+    return transition(p, CellState::VACUUMED, CellState::CLEAN);
 }
 
 bool EnvironmentMap::inBounds(Position p) const {
     return p.x >= 0 && p.y >= 0 && p.x < width_ && p.y < height_;
 }
+
+CellState EnvironmentMap::cellAt(Position p) const {
+    if (!inBounds(p)) {
+        return CellState::CLEAN;
+    }
+    if (storage_ == MapStorage::SPARSE) {
+        std::shared_lock<std::shared_mutex> lock(sparseMutex_);
+        auto it = sparse_.find(indexOf(p));
+        return it == sparse_.end() ? CellState::CLEAN : it->second;
+    }
+    return load(indexOf(p));
+}
+
+std::size_t EnvironmentMap::countCells(CellState state) const {
+    std::size_t count = 0;
+    if (storage_ == MapStorage::SPARSE) {
+        std::shared_lock<std::shared_mutex> lock(sparseMutex_);
+        for (const auto& [idx, cell] : sparse_) {
+            (void)idx;
+            count += cell == state ? 1 : 0;
+        }
+        // every cell missing from the index is CLEAN
+        return state == CellState::CLEAN ? cellCount() - sparse_.size() : count;
+    }
+    const std::size_t total = cellCount();
+    for (std::size_t idx = 0; idx < total; ++idx) {
+        if (load(idx) == state) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+std::size_t EnvironmentMap::storageBytes() const {
+    if (storage_ == MapStorage::SPARSE) {
+        std::shared_lock<std::shared_mutex> lock(sparseMutex_);
+        // buckets plus one node (key, state, next pointer, cached hash) per stored cell
+        const std::size_t node = sizeof(std::uint64_t) * 2 + sizeof(void*) * 2;
+        return sparse_.bucket_count() * sizeof(void*) + sparse_.size() * node;
+    }
+    return wordCount_ * sizeof(std::uint64_t);
+}
+
+void EnvironmentMap::resetCells(std::size_t words) {
+    cells_.reset(words > 0 ? new std::atomic<std::uint64_t>[words] : nullptr);
+    wordCount_ = words;
+    for (std::size_t i = 0; i < words; ++i) {
+        cells_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool EnvironmentMap::transition(Position p, CellState from, CellState to) {
+    if (!inBounds(p)) {
+        return false;
+    }
+    const std::size_t idx = indexOf(p);
+    if (storage_ == MapStorage::SPARSE) {
+        std::unique_lock<std::shared_mutex> lock(sparseMutex_);
+        auto it = sparse_.find(idx);
+        if (it == sparse_.end() || it->second != from) {
+            return false;   // CLEAN is never a transition source
+        }
+        if (to == CellState::CLEAN) {
+            sparse_.erase(it);   // keep only non-CLEAN cells materialized
+        } else {
+            it->second = to;
+        }
+        return true;
+    }
+    // CAS on the containing word so that concurrent transitions of neighbouring cells are not lost
+    std::atomic<std::uint64_t>& word = cells_[idx / kCellsPerWord];
+    const unsigned shift = shiftOf(idx);
+    std::uint64_t current = word.load(std::memory_order_relaxed);
+    for (;;) {
+        if (static_cast<CellState>((current >> shift) & kCellMask) != from) {
+            return false;
+        }
+        const std::uint64_t desired = (current & ~(kCellMask << shift)) | (static_cast<std::uint64_t>(to) << shift);
+        if (word.compare_exchange_weak(current, desired, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
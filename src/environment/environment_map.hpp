@@ -1,15 +1,40 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "robot/robot.hpp"
 
-enum class CellState { CLEAN = 0, DIRTY = 1, VACUUMED = 2 };
+enum class CellState : std::uint8_t { CLEAN = 0, DIRTY = 1, VACUUMED = 2 };
+
+// Cell storage backend, chosen when the grid is initialized.
+enum class MapStorage {
+    DENSE,   // every cell stored, 2 bits each - best when dirt covers a sizeable share of the floor
+    SPARSE   // only non-CLEAN cells stored - memory proportional to the dirt, not to the floor
+};
 
 // EnvironmentMap keeps the grid definition and dirt lifecycle state.
+// DENSE stores cells row-major in one contiguous buffer, 2 bits per cell (32 cells per word);
+// SPARSE keeps a hash index of the cells that are not CLEAN.
+// After initializeGrid, the lifecycle helpers are safe to call from several threads: dense words
+// are updated with compare-and-swap, the sparse index is guarded by a reader/writer lock.
 class EnvironmentMap {
 public:
-    bool initializeGrid(int width, int height, const std::vector<Position>& dirtSpots);
+    bool initializeGrid(int width, int height, const std::vector<Position>& dirtSpots,
+                        MapStorage storage = MapStorage::DENSE);
+    // Streaming initialization, for feeds too big to collect in a vector first: resetGrid gives an
+    // all-CLEAN floor (expectedDirt pre-sizes the SPARSE index), addDirt then marks one spot at a time.
+    // Not thread-safe. An out-of-bounds spot discards the whole grid, like initializeGrid does.
+    bool resetGrid(int width, int height, MapStorage storage = MapStorage::DENSE, std::size_t expectedDirt = 0);
+    bool addDirt(Position p);
+    bool addDirt(std::uint64_t cellIndex);   // row-major: y * width + x
+    // restore a cell in any state (snapshots); CLEAN leaves the cell as resetGrid made it
+    bool addCell(std::uint64_t cellIndex, CellState state);
 
     // Helpers for dirt lifecycle
     bool hasDirt(Position p) const;
@@ -21,10 +46,76 @@ public:
     // Getters
     int width() const { return width_; }
     int height() const { return height_; }
-    const std::vector<std::vector<CellState>>& grid() const { return grid_; }
+    MapStorage storage() const { return storage_; }
+    // state of a single cell (CLEAN when out of bounds)
+    CellState cellAt(Position p) const;
+    // number of cells on the floor and how many of them are in the given state
+    std::size_t cellCount() const { return static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_); }
+    std::size_t countCells(CellState state) const;
+    // approximate bytes used by the cell storage
+    std::size_t storageBytes() const;
+    // visit every cell that is not CLEAN as fn(row-major index, state); DENSE skips clean words,
+    // SPARSE holds the index lock while visiting, in no particular order
+    template<typename Fn>
+    void forEachNonClean(Fn&& fn) const;
 
 private:
+    static constexpr std::size_t kBitsPerCell = 2;
+    static constexpr std::size_t kCellsPerWord = 64 / kBitsPerCell;
+    static constexpr std::uint64_t kCellMask = 0x3;
+
+    std::size_t indexOf(Position p) const {
+        return static_cast<std::size_t>(p.y) * static_cast<std::size_t>(width_) + static_cast<std::size_t>(p.x);
+    }
+    static unsigned shiftOf(std::size_t idx) { return static_cast<unsigned>((idx % kCellsPerWord) * kBitsPerCell); }
+    CellState load(std::size_t idx) const {
+        const std::uint64_t word = cells_[idx / kCellsPerWord].load(std::memory_order_relaxed);
+        return static_cast<CellState>((word >> shiftOf(idx)) & kCellMask);
+    }
+    // initialization only - not atomic with respect to concurrent transitions
+    void store(std::size_t idx, CellState state) {
+        std::atomic<std::uint64_t>& word = cells_[idx / kCellsPerWord];
+        const std::uint64_t old = word.load(std::memory_order_relaxed);
+        word.store((old & ~(kCellMask << shiftOf(idx))) | (static_cast<std::uint64_t>(state) << shiftOf(idx)),
+                   std::memory_order_relaxed);
+    }
+    void resetCells(std::size_t words);
+    void discardGrid();
+    // initialization only, like store()
+    void markCell(std::size_t idx, CellState state) {
+        if (storage_ == MapStorage::DENSE) {
+            store(idx, state);
+        } else {
+            sparse_[idx] = state;
+        }
+    }
+    // replace `from` with `to` at p; false if out of bounds or the cell is not in state `from`
+    bool transition(Position p, CellState from, CellState to);
+
     int width_{0};
     int height_{0};
-    std::vector<std::vector<CellState>> grid_;
+    MapStorage storage_{MapStorage::DENSE};
+    std::unique_ptr<std::atomic<std::uint64_t>[]> cells_;   // DENSE backend
+    std::size_t wordCount_{0};
+    std::unordered_map<std::uint64_t, CellState> sparse_;    // SPARSE backend: cell index -> non-CLEAN state
+    mutable std::shared_mutex sparseMutex_;
 };
+
+template<typename Fn>
+void EnvironmentMap::forEachNonClean(Fn&& fn) const {
+    if (storage_ == MapStorage::SPARSE) {
+        std::shared_lock<std::shared_mutex> lock(sparseMutex_);
+        for (const auto& [idx, cell] : sparse_) {
+            fn(static_cast<std::uint64_t>(idx), cell);
+        }
+        return;
+    }
+    for (std::size_t w = 0; w < wordCount_; ++w) {
+        std::uint64_t word = cells_[w].load(std::memory_order_relaxed);
+        for (std::size_t idx = w * kCellsPerWord; word != 0; ++idx, word >>= kBitsPerCell) {
+            if ((word & kCellMask) != 0) {
+                fn(static_cast<std::uint64_t>(idx), static_cast<CellState>(word & kCellMask));
+            }
+        }
+    }
+}
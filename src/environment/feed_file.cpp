@@ -0,0 +1,335 @@
+#include "environment/feed_file.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/little_endian.hpp"
+
+// ---- helper functions inside anonymous namespace ----
+namespace {
+constexpr std::uint32_t kFeedMagic = 0x44464352;   // "RCFD"
+constexpr std::uint16_t kFeedVersion = 1;
+
+std::uint64_t cellsOf(int width, int height) {
+    return static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+}
+
+std::size_t indexBytes(FeedEncoding encoding) {
+    return encoding == FeedEncoding::CELL_INDEX32 ? 4 : 8;
+}
+
+// Streams a feed file out: header first (the spot count is patched in by finish()), then either
+// cell indices as they come or, for BITMAP, the bitmap collected in memory.
+class FeedWriter {
+public:
+    FeedWriter(const std::string& path, int width, int height, FeedEncoding encoding, MapStorage storage)
+        : path_(path), width_(width), height_(height), encoding_(encoding), storage_(storage) {
+        if (width <= 0 || height <= 0) {
+            std::cerr << "[Feed] grid dimensions must be positive (" << width << "x" << height << ")\n";
+            return;
+        }
+        if (encoding == FeedEncoding::CELL_INDEX32 && cellsOf(width, height) > (std::uint64_t{1} << 32)) {
+            std::cerr << "[Feed] " << width << "x" << height << " floor is too big for 32-bit cell indices\n";
+            return;
+        }
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            std::cerr << "[Feed] cannot create " << path << "\n";
+            return;
+        }
+        std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+        if (encoding_ == FeedEncoding::BITMAP) {
+            bitmap_.assign((cellsOf(width, height) + 7) / 8, 0);
+        }
+        ok_ = writeHeader();
+    }
+    ~FeedWriter() {
+        if (file_) {
+            std::fclose(file_);
+            std::remove(path_.c_str());   // finish() was not reached: drop the partial file
+        }
+    }
+
+    bool ok() const { return ok_; }
+
+    bool add(Position p) {
+        if (p.x < 0 || p.y < 0 || p.x >= width_ || p.y >= height_) {
+            std::cerr << "[Feed] dirt spot out of bounds at (" << p.x << "," << p.y << ")\n";
+            return ok_ = false;
+        }
+        const std::uint64_t idx = static_cast<std::uint64_t>(p.y) * static_cast<std::uint64_t>(width_)
+                                + static_cast<std::uint64_t>(p.x);
+        if (encoding_ == FeedEncoding::BITMAP) {
+            const std::uint8_t bit = static_cast<std::uint8_t>(1u << (idx % 8));
+            spots_ += (bitmap_[idx / 8] & bit) == 0;
+            bitmap_[idx / 8] |= bit;
+            return true;
+        }
+        std::uint8_t bytes[8];
+        writeLE(bytes, idx);
+        ++spots_;
+        return ok_ = std::fwrite(bytes, indexBytes(encoding_), 1, file_) == 1;
+    }
+
+    bool finish() {
+        if (!ok_) {
+            return false;
+        }
+        if (encoding_ == FeedEncoding::BITMAP) {
+            ok_ = std::fwrite(bitmap_.data(), 1, bitmap_.size(), file_) == bitmap_.size();
+        }
+        ok_ = ok_ && std::fseek(file_, 0, SEEK_SET) == 0 && writeHeader();
+        const bool closed = std::fclose(file_) == 0;
+        file_ = nullptr;
+        if (!ok_ || !closed) {
+            std::cerr << "[Feed] failed writing " << path_ << "\n";
+            std::remove(path_.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool writeHeader() {
+        std::uint8_t header[FeedFile::kHeaderSize] = {};
+        writeLE(header + 0, kFeedMagic);
+        writeLE(header + 4, kFeedVersion);
+        header[6] = static_cast<std::uint8_t>(encoding_);
+        header[7] = static_cast<std::uint8_t>(storage_);
+        writeLE(header + 8, static_cast<std::uint32_t>(width_));
+        writeLE(header + 12, static_cast<std::uint32_t>(height_));
+        writeLE(header + 16, spots_);
+        return std::fwrite(header, sizeof(header), 1, file_) == 1;
+    }
+
+    std::string path_;
+    int width_;
+    int height_;
+    FeedEncoding encoding_;
+    MapStorage storage_;
+    std::FILE* file_{nullptr};
+    bool ok_{false};
+    std::uint64_t spots_{0};
+    std::vector<std::uint8_t> bitmap_;
+};
+
+// parse the leading "a b" integer pair of a text feed line; false for blank and comment lines
+bool parsePair(const char* line, int& a, int& b, bool& malformed) {
+    const char* end = line + std::strlen(line);
+    const char* p = line;
+    auto skipSpace = [&] {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r' || *p == '\n')) {
+            ++p;
+        }
+    };
+    skipSpace();
+    if (p == end || *p == '#') {
+        return false;
+    }
+    auto res = std::from_chars(p, end, a);
+    p = res.ptr;
+    skipSpace();
+    if (res.ec == std::errc()) {
+        res = std::from_chars(p, end, b);
+        p = res.ptr;
+        skipSpace();
+    }
+    malformed = res.ec != std::errc() || (p != end && *p != '#');
+    return !malformed;
+}
+}
+
+/////////// reading
+
+FeedFile FeedFile::open(const std::string& path) {
+    FeedFile feed;
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[Feed] cannot open " << path << "\n";
+        return feed;
+    }
+    struct stat st {};
+    void* mem = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= kHeaderSize) {
+        mem = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        std::cerr << "[Feed] " << path << " is not a feed file\n";
+        return feed;
+    }
+    ::madvise(mem, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+    feed.data_ = static_cast<const std::uint8_t*>(mem);
+    feed.size_ = static_cast<std::size_t>(st.st_size);
+
+    const std::uint8_t* header = feed.data_;
+    const std::uint8_t encoding = header[6];
+    const std::uint8_t storage = header[7];
+    feed.width_ = static_cast<int>(readLE<std::uint32_t>(header + 8));
+    feed.height_ = static_cast<int>(readLE<std::uint32_t>(header + 12));
+    feed.spotCount_ = readLE<std::uint64_t>(header + 16);
+    if (readLE<std::uint32_t>(header) != kFeedMagic || readLE<std::uint16_t>(header + 4) != kFeedVersion
+        || encoding > static_cast<std::uint8_t>(FeedEncoding::BITMAP) || storage > 1
+        || feed.width_ <= 0 || feed.height_ <= 0) {
+        std::cerr << "[Feed] " << path << " has an unsupported header\n";
+        feed.release();
+        return feed;
+    }
+    feed.encoding_ = static_cast<FeedEncoding>(encoding);
+    feed.storage_ = storage == 0 ? MapStorage::DENSE : MapStorage::SPARSE;
+
+    // a bitmap holds at most one spot per cell; index payloads grow with the spot count, so bounding
+    // it by the file size first keeps the multiplication from overflowing
+    const bool bitmap = feed.encoding_ == FeedEncoding::BITMAP;
+    const std::uint64_t cells = cellsOf(feed.width_, feed.height_);
+    const std::uint64_t maxSpots = bitmap ? cells : feed.size_;
+    const std::uint64_t payload = bitmap ? (cells + 7) / 8 : feed.spotCount_ * indexBytes(feed.encoding_);
+    if (feed.spotCount_ > maxSpots || feed.size_ - kHeaderSize != payload) {
+        std::cerr << "[Feed] " << path << " is truncated or has trailing data\n";
+        feed.release();
+    }
+    return feed;
+}
+
+FeedFile::FeedFile(FeedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), width_(other.width_), height_(other.height_),
+      encoding_(other.encoding_), storage_(other.storage_), spotCount_(other.spotCount_) {
+    other.data_ = nullptr;
+}
+
+FeedFile& FeedFile::operator=(FeedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        width_ = other.width_;
+        height_ = other.height_;
+        encoding_ = other.encoding_;
+        storage_ = other.storage_;
+        spotCount_ = other.spotCount_;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+FeedFile::~FeedFile() {
+    release();
+}
+
+void FeedFile::release() {
+    if (data_) {
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+        data_ = nullptr;
+    }
+}
+
+bool FeedFile::loadInto(EnvironmentMap& map) const {
+    if (!isOpen() || !map.resetGrid(width_, height_, storage_, static_cast<std::size_t>(spotCount_))) {
+        return false;
+    }
+    const std::uint8_t* payload = data_ + kHeaderSize;
+
+    if (encoding_ == FeedEncoding::BITMAP) {
+        // whole 64-bit words first, skipping clean stretches; then the tail bytes
+        const std::size_t bytes = size_ - kHeaderSize;
+        std::size_t byte = 0;
+        for (; byte + 8 <= bytes; byte += 8) {
+            std::uint64_t word = readLE<std::uint64_t>(payload + byte);
+            while (word != 0) {
+                const std::uint64_t idx = byte * 8 + static_cast<std::uint64_t>(__builtin_ctzll(word));
+                word &= word - 1;
+                if (!map.addDirt(idx)) {
+                    return false;
+                }
+            }
+        }
+        for (; byte < bytes; ++byte) {
+            for (unsigned bit = 0; bit < 8; ++bit) {
+                if ((payload[byte] >> bit) & 1u) {
+                    if (!map.addDirt(std::uint64_t{byte * 8 + bit})) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    const std::size_t stride = indexBytes(encoding_);
+    for (std::uint64_t i = 0; i < spotCount_; ++i) {
+        const std::uint8_t* p = payload + i * stride;
+        const std::uint64_t idx = encoding_ == FeedEncoding::CELL_INDEX32 ? readLE<std::uint32_t>(p)
+                                                                          : readLE<std::uint64_t>(p);
+        if (!map.addDirt(idx)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/////////// writing
+
+FeedEncoding smallestFeedEncoding(int width, int height, std::size_t spots) {
+    const std::uint64_t cells = cellsOf(width, height);
+    const FeedEncoding index = cells > (std::uint64_t{1} << 32) ? FeedEncoding::CELL_INDEX64 : FeedEncoding::CELL_INDEX32;
+    return (cells + 7) / 8 < spots * indexBytes(index) ? FeedEncoding::BITMAP : index;
+}
+
+bool writeFeedFile(const std::string& path, const BootstrapFeed& feed, FeedEncoding encoding) {
+    FeedWriter writer(path, feed.gridWidth, feed.gridHeight, encoding, feed.storage);
+    for (const Position& spot : feed.dirtSpots) {
+        if (!writer.ok() || !writer.add(spot)) {
+            return false;
+        }
+    }
+    return writer.finish();
+}
+
+bool convertTextFeed(const std::string& textPath, const std::string& feedPath, FeedEncoding encoding,
+                     MapStorage storage) {
+    std::FILE* in = std::fopen(textPath.c_str(), "r");
+    if (!in) {
+        std::cerr << "[Feed] cannot open " << textPath << "\n";
+        return false;
+    }
+
+    char line[256];
+    long lineNo = 0;
+    int width = 0;
+    int height = 0;
+    bool malformed = false;
+    bool haveSize = false;
+    while (!haveSize && std::fgets(line, sizeof(line), in)) {
+        ++lineNo;
+        haveSize = parsePair(line, width, height, malformed);
+        if (malformed) {
+            break;
+        }
+    }
+    if (!haveSize) {
+        std::cerr << "[Feed] " << textPath << ":" << lineNo << ": expected \"width height\"\n";
+        std::fclose(in);
+        return false;
+    }
+
+    FeedWriter writer(feedPath, width, height, encoding, storage);
+    Position spot;
+    while (writer.ok() && std::fgets(line, sizeof(line), in)) {
+        ++lineNo;
+        if (parsePair(line, spot.x, spot.y, malformed)) {
+            writer.add(spot);
+        } else if (malformed) {
+            std::cerr << "[Feed] " << textPath << ":" << lineNo << ": expected \"x y\"\n";
+            break;
+        }
+    }
+    std::fclose(in);
+    return !malformed && writer.finish();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "common/bootstrap.hpp"
+#include "environment/environment_map.hpp"
+
+// Compact on-disk form of a BootstrapFeed, for survey data with millions of dirt spots.
+//
+// A 32-byte header is followed by the payload; all fields are little-endian:
+//   u32 magic "RCFD" | u16 version | u8 FeedEncoding | u8 MapStorage | i32 width | i32 height |
+//   u64 spot count | u64 reserved
+// CELL_INDEX32/64 payloads are the row-major cell indices (y * width + x) of the dirt spots;
+// a BITMAP payload has one bit per cell, row-major, least significant bit first.
+// FeedFile memory-maps the file and streams the spots straight into an EnvironmentMap, so no
+// intermediate vector is built and loading is bounded by how fast the pages come in.
+
+enum class FeedEncoding : std::uint8_t {
+    CELL_INDEX32 = 0,   // 4 bytes per spot, floors of up to 2^32 cells
+    CELL_INDEX64 = 1,   // 8 bytes per spot
+    BITMAP       = 2,   // width * height / 8 bytes, whatever the number of spots
+};
+
+class FeedFile {
+public:
+    static constexpr std::size_t kHeaderSize = 32;
+
+    // map an existing feed file read-only; check isOpen() (problems are reported on std::cerr)
+    static FeedFile open(const std::string& path);
+
+    FeedFile() = default;
+    FeedFile(FeedFile&& other) noexcept;
+    FeedFile& operator=(FeedFile&& other) noexcept;
+    FeedFile(const FeedFile&) = delete;
+    FeedFile& operator=(const FeedFile&) = delete;
+    ~FeedFile();
+
+    bool isOpen() const { return data_ != nullptr; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    FeedEncoding encoding() const { return encoding_; }
+    MapStorage storage() const { return storage_; }
+    std::uint64_t spotCount() const { return spotCount_; }
+
+    // reset `map` to the feed's floor and mark every spot dirty; false if a spot is off the floor
+    bool loadInto(EnvironmentMap& map) const;
+
+private:
+    void release();
+
+    const std::uint8_t* data_{nullptr};
+    std::size_t size_{0};
+    int width_{0};
+    int height_{0};
+    FeedEncoding encoding_{FeedEncoding::CELL_INDEX32};
+    MapStorage storage_{MapStorage::DENSE};
+    std::uint64_t spotCount_{0};
+};
+
+// the smaller encoding for `spots` dirt spots on a width x height floor
+FeedEncoding smallestFeedEncoding(int width, int height, std::size_t spots);
+// write `feed` (grid, spots and storage; scan patterns are not stored) in the binary format
+bool writeFeedFile(const std::string& path, const BootstrapFeed& feed, FeedEncoding encoding);
+// convert a text feed - "width height" on the first line, then one "x y" per line, '#' starts a
+// comment - into the binary format without holding the spots in memory (BITMAP holds the bitmap)
+bool convertTextFeed(const std::string& textPath, const std::string& feedPath, FeedEncoding encoding,
+                     MapStorage storage = MapStorage::DENSE);
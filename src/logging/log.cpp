@@ -0,0 +1,152 @@
+#include "logging/log.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bus/event_ring.hpp"
+#include "common/little_endian.hpp"
+
+namespace {
+
+// Owns the record ring and the writer thread; created on first use, drained and joined at exit.
+class LogWriter {
+public:
+    static constexpr std::size_t kCapacity = 1u << 13;
+    static constexpr std::size_t kBatch = 256;
+
+    static LogWriter& instance() {
+        static LogWriter writer;
+        return writer;
+    }
+
+    ~LogWriter() {
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void submit(LogRecord& record) {
+        record.nanos = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        // lossless: a full ring makes the caller wait for the writer, like Bus::publish
+        while (!ring_.tryPush(std::move(record))) {
+            wake_.notify_one();
+            std::this_thread::yield();
+        }
+        submitted_.fetch_add(1, std::memory_order_release);
+    }
+
+    void flush() {
+        const std::uint64_t target = submitted_.load(std::memory_order_acquire);
+        if (written_.load() < target) {
+            std::unique_lock<std::mutex> lock(drainMutex_);
+            flushWaiters_.fetch_add(1);
+            wake_.notify_one();
+            drained_.wait(lock, [&] { return written_.load() >= target; });
+            flushWaiters_.fetch_sub(1);
+        }
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        std::fflush(out_);
+    }
+
+    void setOutput(std::FILE* out, LogFormat format) {
+        flush();
+        std::lock_guard<std::mutex> lock(outputMutex_);
+        out_ = out;
+        format_ = format;
+    }
+
+private:
+    LogWriter() : ring_(kCapacity), thread_([this] { run(); }) {}
+
+    void run() {
+        std::vector<LogRecord> batch;
+        batch.reserve(kBatch);
+        for (;;) {
+            batch.clear();
+            if (ring_.tryPopBatch(batch, kBatch) == 0) {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                if (stopping_) {
+                    return;
+                }
+                // producers never lock; poll again after a short sleep unless woken earlier
+                wake_.wait_for(lock, std::chrono::milliseconds(1));
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(outputMutex_);
+                for (const LogRecord& record : batch) {
+                    writeRecord(record);
+                }
+            }
+            // seq_cst pairs with flush(): either it sees the new count or this sees its waiter
+            written_.fetch_add(batch.size());
+            if (flushWaiters_.load() > 0) {
+                { std::lock_guard<std::mutex> lock(drainMutex_); }
+                drained_.notify_all();
+            }
+        }
+    }
+
+    void writeRecord(const LogRecord& record) {
+        if (format_ == LogFormat::TEXT) {
+            std::fwrite(record.text, 1, record.length, out_);
+            std::fputc('\n', out_);
+            return;
+        }
+        std::uint8_t header[11];
+        writeLE(header, record.nanos);
+        header[8] = static_cast<std::uint8_t>(record.level);
+        writeLE(header + 9, record.length);
+        std::fwrite(header, 1, sizeof(header), out_);
+        std::fwrite(record.text, 1, record.length, out_);
+    }
+
+    EventRing<LogRecord> ring_;
+    std::atomic<std::uint64_t> submitted_{0};
+    std::atomic<std::uint64_t> written_{0};
+
+    std::mutex outputMutex_;   // guards out_/format_ against setOutput()
+    std::FILE* out_{stdout};
+    LogFormat  format_{LogFormat::TEXT};
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_{false};
+
+    // flush() sleeps on drained_ until the writer has caught up with it
+    std::mutex drainMutex_;
+    std::condition_variable drained_;
+    std::atomic<int> flushWaiters_{0};
+
+    std::thread thread_;   // last: starts once everything above is constructed
+};
+
+}  // namespace
+
+void Log::submit(LogRecord& record) {
+    LogWriter& writer = LogWriter::instance();
+    const bool diagnostic = record.level >= LogLevel::WARN;
+    writer.submit(record);
+    // warnings and errors stand in for direct std::cerr diagnostics: they must not trail the output
+    // written after them
+    if (diagnostic) {
+        writer.flush();
+    }
+}
+
+void Log::flush() {
+    LogWriter::instance().flush();
+}
+
+void Log::setOutput(std::FILE* out, LogFormat format) {
+    LogWriter::instance().setOutput(out, format);
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Structured logging for the simulation hot paths.
+//
+// LOG_DEBUG("[Vacuum#", name, "] start vacuuming") concatenates its arguments into a fixed-size
+// record (integers via std::to_chars, no iostreams, no allocation) and hands the record to a
+// lock-free ring; a background thread writes the records out. Records below the compile-time
+// level (LOG_COMPILE_LEVEL, e.g. -DLOG_COMPILE_LEVEL=3 keeps WARN and up) are compiled out
+// entirely, records below the runtime level are skipped before any formatting happens.
+//
+// Output is asynchronous: call Log::flush() before writing to stdout by other means. WARN and ERROR
+// records are the exception, LOG_WARN/LOG_ERROR return once their record has been written out.
+
+enum class LogLevel : std::uint8_t { TRACE, DEBUG, INFO, WARN, ERROR, OFF };
+
+enum class LogFormat : std::uint8_t {
+    TEXT,    // message followed by '\n'
+    BINARY,  // frames: u64 steady-clock ns, u8 level, u16 length, message bytes (little-endian)
+};
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+// One formatted log line; longer messages are truncated.
+struct LogRecord {
+    static constexpr std::size_t kMaxText = 244;
+
+    std::uint64_t nanos{0};
+    LogLevel      level{LogLevel::INFO};
+    std::uint16_t length{0};
+    char          text[kMaxText];
+
+    void append(std::string_view s) {
+        const std::size_t n = std::min(s.size(), kMaxText - length);
+        std::memcpy(text + length, s.data(), n);
+        length = static_cast<std::uint16_t>(length + n);
+    }
+    void append(const char* s) { append(std::string_view(s)); }
+    void append(const std::string& s) { append(std::string_view(s)); }
+    void append(char c) {
+        if (length < kMaxText) {
+            text[length++] = c;
+        }
+    }
+    template<typename Int, typename = std::enable_if_t<std::is_integral_v<Int> && !std::is_same_v<Int, char>>>
+    void append(Int value) {
+        const auto res = std::to_chars(text + length, text + kMaxText, value);
+        if (res.ec == std::errc()) {
+            length = static_cast<std::uint16_t>(res.ptr - text);
+        }
+    }
+};
+
+class Log {
+public:
+    // true if records of `level` survive LOG_COMPILE_LEVEL (compared through a variable: with the
+    // macro spelled out, LOG_COMPILE_LEVEL=0 makes the comparison trip -Wtype-limits)
+    static constexpr bool compiledIn(LogLevel level) { return static_cast<int>(level) >= kCompileLevel; }
+    static LogLevel level() { return runtimeLevel_.load(std::memory_order_relaxed); }
+    static void setLevel(LogLevel level) { runtimeLevel_.store(level, std::memory_order_relaxed); }
+    static bool enabled(LogLevel level) { return level >= Log::level() && level != LogLevel::OFF; }
+
+    // direct output to `out` (default stdout) in the given format; flushes what is pending first
+    static void setOutput(std::FILE* out, LogFormat format = LogFormat::TEXT);
+
+    template<typename... Args>
+    static void write(LogLevel level, const Args&... args) {
+        LogRecord record;
+        record.level = level;
+        (record.append(args), ...);
+        submit(record);
+    }
+
+    // block until every record submitted so far has been written out
+    static void flush();
+
+private:
+    static constexpr int kCompileLevel = LOG_COMPILE_LEVEL;
+
+    static void submit(LogRecord& record);
+
+    static inline std::atomic<LogLevel> runtimeLevel_{LogLevel::DEBUG};
+};
+
+// true if records of `lvl` would be emitted; use it to guard extra work done only for a log line
+#define LOG_ENABLED(lvl) (Log::compiledIn(lvl) && Log::enabled(lvl))
+
+#define LOG_AT(lvl, ...)                                                        \
+    do {                                                                        \
+        if constexpr (Log::compiledIn(lvl)) {                                   \
+            if (Log::enabled(lvl)) {                                            \
+                Log::write(lvl, __VA_ARGS__);                                   \
+            }                                                                   \
+        }                                                                       \
+    } while (0)
+
+#define LOG_TRACE(...) LOG_AT(LogLevel::TRACE, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::ERROR, __VA_ARGS__)
@@ -1,68 +1,315 @@
 #include "messages/messages.hpp"
-#include <sstream>
 
-// Helper for formatting Position
-static std::string posStr(Position p) {
-    std::ostringstream os;
-    os << "(" << p.x << "," << p.y << ")";
-    return os.str();
-}
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include "common/little_endian.hpp"
+
+namespace {
+
+// Appends text and numbers to a fixed buffer, silently truncating at its end.
+class TextWriter {
+public:
+    TextWriter(char* buf, std::size_t size) : begin_(buf), cur_(buf), end_(buf + size) {}
+
+    TextWriter& operator<<(std::string_view s) {
+        const std::size_t n = std::min(s.size(), static_cast<std::size_t>(end_ - cur_));
+        std::memcpy(cur_, s.data(), n);
+        cur_ += n;
+        return *this;
+    }
+    TextWriter& operator<<(const char* s) { return *this << std::string_view(s); }
+    template<typename Int, typename = std::enable_if_t<std::is_integral_v<Int>>>
+    TextWriter& operator<<(Int value) {
+        const auto res = std::to_chars(cur_, end_, value);
+        if (res.ec == std::errc()) {
+            cur_ = res.ptr;
+        } else {
+            end_ = cur_;   // did not fit - std::to_chars wrote nothing; stop writing here
+        }
+        return *this;
+    }
+    TextWriter& operator<<(Position p) { return *this << "(" << p.x << "," << p.y << ")"; }
+
+    std::size_t size() const { return static_cast<std::size_t>(cur_ - begin_); }
+
+private:
+    char* begin_;
+    char* cur_;
+    char* end_;
+};
 
+template<typename Message>
+std::string formatToString(const Message& m) {
+    char buf[kMaxMessageText];
+    return std::string(buf, toChars(m, buf, sizeof(buf)));
+}
 
-// Only toString functions below
+}  // namespace
 
+const char* workKindName(WorkKind kind) {
+    switch (kind) {
+    case WorkKind::DETECT: return "DETECT";
+    case WorkKind::VACUUM: return "VACUUM";
+    case WorkKind::WASH:   return "WASH";
+    case WorkKind::NONE:   break;
+    }
+    return "NONE";
+}
 
 // --------- Events ---------
 
-std::string toString(const DetectionEvent& e) {
-    std::ostringstream os;
-    os << "[DetectionEvent] from=" << e.from
-       << " position=" << posStr(e.position);
-    return os.str();
+std::size_t toChars(const DetectionEvent& e, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[DetectionEvent] from=" << e.from
+        << " position=" << e.position;
+    return out.size();
 }
 
-std::string toString(const StatusEvent& e) {
-    std::ostringstream os;
-    os << "[StatusEvent] from=" << e.from
-       << " type=" << static_cast<int>(e.type)
-       << " state=" << static_cast<int>(e.state)
-       << " position=" << posStr(e.position);
-    return os.str();
+std::size_t toChars(const StatusEvent& e, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[StatusEvent] from=" << e.from
+        << " type=" << static_cast<int>(e.type)
+        << " state=" << static_cast<int>(e.state)
+        << " position=" << e.position;
+    return out.size();
 }
 
-std::string toString(const WorkCompletedEvent& e) {
-    std::ostringstream os;
-    os << "[WorkCompletedEvent] from=" << e.from
-       << " kind=" << e.workKind
-       << " position=" << posStr(e.position)
-       << " ok=" << (e.success ? "true" : "false");
-    return os.str();
+std::size_t toChars(const WorkCompletedEvent& e, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[WorkCompletedEvent] from=" << e.from
+        << " kind=" << workKindName(e.workKind)
+        << " position=" << e.position
+        << " ok=" << (e.success ? "true" : "false");
+    return out.size();
 }
 
 // -------- Commands --------
 
-std::string toString(const MoveCommand& c) {
-    std::ostringstream os;
-    os << "[MoveCommand] to=" << c.to
-       << " position=" << posStr(c.position);
-    return os.str();
+std::size_t toChars(const MoveCommand& c, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[MoveCommand] to=" << c.to
+        << " position=" << c.position;
+    return out.size();
+}
+
+std::size_t toChars(const StartWorkCommand& c, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[StartWorkCommand] to=" << c.to
+        << " kind=" << workKindName(c.kind);
+    return out.size();
+}
+
+std::size_t toChars(const StopCommand& c, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[StopCommand] to=" << c.to;
+    return out.size();
+}
+
+std::size_t toChars(const TickCommand& c, char* buf, std::size_t size) {
+    TextWriter out(buf, size);
+    out << "[TickCommand] to=" << c.to << " now=" << c.now;
+    return out.size();
+}
+
+// -------- Owning strings --------
+
+std::string toString(WorkKind kind) { return workKindName(kind); }
+std::string toString(const DetectionEvent& e) { return formatToString(e); }
+std::string toString(const StatusEvent& e) { return formatToString(e); }
+std::string toString(const WorkCompletedEvent& e) { return formatToString(e); }
+std::string toString(const MoveCommand& c) { return formatToString(c); }
+std::string toString(const StartWorkCommand& c) { return formatToString(c); }
+std::string toString(const StopCommand& c) { return formatToString(c); }
+std::string toString(const TickCommand& c) { return formatToString(c); }
+
+// -------- Binary wire format --------
+
+namespace {
+
+// field writers / readers over common/little_endian.hpp; `pos` advances past the field
+template<typename T>
+void put(std::uint8_t* buf, std::size_t& pos, T v) {
+    writeLE(buf + pos, v);
+    pos += sizeof(T);
+}
+void putPos(std::uint8_t* buf, std::size_t& pos, Position p) {
+    put<std::int32_t>(buf, pos, p.x);
+    put<std::int32_t>(buf, pos, p.y);
+}
+
+template<typename T>
+T get(const std::uint8_t* buf, std::size_t& pos) {
+    const T v = readLE<T>(buf + pos);
+    pos += sizeof(T);
+    return v;
+}
+Position getPos(const std::uint8_t* buf, std::size_t& pos) {
+    Position p;
+    p.x = get<std::int32_t>(buf, pos);
+    p.y = get<std::int32_t>(buf, pos);
+    return p;
+}
+
+// frame sizes, see the table in messages.hpp
+constexpr std::size_t kDetectionSize = 13;
+constexpr std::size_t kStatusSize = 15;
+constexpr std::size_t kWorkCompletedSize = 15;
+constexpr std::size_t kMoveSize = 13;
+constexpr std::size_t kStartWorkSize = 6;
+constexpr std::size_t kStopSize = 5;
+constexpr std::size_t kTickSize = 13;
+
+bool frameOk(const std::uint8_t* buf, std::size_t len, MessageTag tag, std::size_t size) {
+    return buf && len >= size && buf[0] == static_cast<std::uint8_t>(tag);
+}
+
+// enum range checks - reject frames carrying values this build does not know
+bool validType(std::uint8_t v) { return v <= static_cast<std::uint8_t>(RobotType::WASHER); }
+bool validState(std::uint8_t v) { return v <= static_cast<std::uint8_t>(RobotState::ERROR); }
+bool validKind(std::uint8_t v) { return v <= static_cast<std::uint8_t>(WorkKind::WASH); }
+
+}
+
+std::size_t encode(const DetectionEvent& e, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::DETECTION));
+    put<std::int32_t>(buf, pos, e.from);
+    putPos(buf, pos, e.position);
+    return pos;
+}
+
+std::size_t encode(const StatusEvent& e, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::STATUS));
+    put<std::int32_t>(buf, pos, e.from);
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(e.type));
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(e.state));
+    putPos(buf, pos, e.position);
+    return pos;
+}
+
+std::size_t encode(const WorkCompletedEvent& e, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::WORK_COMPLETED));
+    put<std::int32_t>(buf, pos, e.from);
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(e.workKind));
+    put<std::uint8_t>(buf, pos, e.success ? 1 : 0);
+    putPos(buf, pos, e.position);
+    return pos;
+}
+
+std::size_t encode(const MoveCommand& c, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::MOVE));
+    put<std::int32_t>(buf, pos, c.to);
+    putPos(buf, pos, c.position);
+    return pos;
+}
+
+std::size_t encode(const StartWorkCommand& c, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::START_WORK));
+    put<std::int32_t>(buf, pos, c.to);
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(c.kind));
+    return pos;
+}
+
+std::size_t encode(const StopCommand& c, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::STOP));
+    put<std::int32_t>(buf, pos, c.to);
+    return pos;
+}
+
+std::size_t encode(const TickCommand& c, std::uint8_t* buf) {
+    std::size_t pos = 0;
+    put<std::uint8_t>(buf, pos, static_cast<std::uint8_t>(MessageTag::TICK));
+    put<std::int32_t>(buf, pos, c.to);
+    put<std::uint64_t>(buf, pos, c.now);
+    return pos;
+}
+
+bool peekTag(const std::uint8_t* buf, std::size_t len, MessageTag& out) {
+    if (!buf || len == 0 || buf[0] < static_cast<std::uint8_t>(MessageTag::DETECTION)
+        || buf[0] > static_cast<std::uint8_t>(MessageTag::TICK)) {
+        return false;
+    }
+    out = static_cast<MessageTag>(buf[0]);
+    return true;
+}
+
+bool decode(const std::uint8_t* buf, std::size_t len, DetectionEvent& out) {
+    if (!frameOk(buf, len, MessageTag::DETECTION, kDetectionSize)) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.from = get<std::int32_t>(buf, pos);
+    out.position = getPos(buf, pos);
+    return true;
+}
+
+bool decode(const std::uint8_t* buf, std::size_t len, StatusEvent& out) {
+    if (!frameOk(buf, len, MessageTag::STATUS, kStatusSize) || !validType(buf[5]) || !validState(buf[6])) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.from = get<std::int32_t>(buf, pos);
+    out.type = static_cast<RobotType>(get<std::uint8_t>(buf, pos));
+    out.state = static_cast<RobotState>(get<std::uint8_t>(buf, pos));
+    out.position = getPos(buf, pos);
+    return true;
+}
+
+bool decode(const std::uint8_t* buf, std::size_t len, WorkCompletedEvent& out) {
+    if (!frameOk(buf, len, MessageTag::WORK_COMPLETED, kWorkCompletedSize) || !validKind(buf[5])) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.from = get<std::int32_t>(buf, pos);
+    out.workKind = static_cast<WorkKind>(get<std::uint8_t>(buf, pos));
+    out.success = get<std::uint8_t>(buf, pos) != 0;
+    out.position = getPos(buf, pos);
+    return true;
+}
+
+bool decode(const std::uint8_t* buf, std::size_t len, MoveCommand& out) {
+    if (!frameOk(buf, len, MessageTag::MOVE, kMoveSize)) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.to = get<std::int32_t>(buf, pos);
+    out.position = getPos(buf, pos);
+    return true;
 }
 
-std::string toString(const StartWorkCommand& c) {
-    std::ostringstream os;
-    os << "[StartWorkCommand] to=" << c.to
-       << " kind=" << c.kind;
-    return os.str();
+bool decode(const std::uint8_t* buf, std::size_t len, StartWorkCommand& out) {
+    if (!frameOk(buf, len, MessageTag::START_WORK, kStartWorkSize) || !validKind(buf[5])) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.to = get<std::int32_t>(buf, pos);
+    out.kind = static_cast<WorkKind>(get<std::uint8_t>(buf, pos));
+    return true;
 }
 
-std::string toString(const StopCommand& c) {
-    std::ostringstream os;
-    os << "[StopCommand] to=" << c.to;
-    return os.str();
+bool decode(const std::uint8_t* buf, std::size_t len, StopCommand& out) {
+    if (!frameOk(buf, len, MessageTag::STOP, kStopSize)) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.to = get<std::int32_t>(buf, pos);
+    return true;
 }
 
-std::string toString(const TickCommand& c) {
-    std::ostringstream os;
-    os << "[TickCommand] now=" << c.now;
-    return os.str();
+bool decode(const std::uint8_t* buf, std::size_t len, TickCommand& out) {
+    if (!frameOk(buf, len, MessageTag::TICK, kTickSize)) {
+        return false;
+    }
+    std::size_t pos = 1;
+    out.to = get<std::int32_t>(buf, pos);
+    out.now = get<std::uint64_t>(buf, pos);
+    return true;
 }
@@ -1,5 +1,8 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include "common/types.hpp"   // RobotId, Position, RobotType, RobotState
 
 // -------------------------
@@ -23,9 +26,9 @@ struct StatusEvent {
 // A robot notifies that it has finished its work (vacuuming, washing, etc.).
 struct WorkCompletedEvent {
     RobotId      from{0};      
-    std::string  workKind;     // "DETECT" / "VACUUM" / "WASH"
-    Position     position{};   
+    WorkKind     workKind{WorkKind::NONE};
     bool         success{true}; // true if finished successfully
+    Position     position{};   
 };
 
 // -------------------------
@@ -41,7 +44,7 @@ struct MoveCommand {
 // Order a robot to start a specific kind of work.
 struct StartWorkCommand {
     RobotId     to{0};    
-    std::string kind;     // "DETECT" / "VACUUM" / "WASH"
+    WorkKind    kind{WorkKind::NONE};   // NONE = the robot's own kind of work
 };
 
 // Order a robot to stop its current work.
@@ -49,14 +52,96 @@ struct StopCommand {
     RobotId to{0};        
 };
 
-// Optional time broadcast — kept for future extension but unused now.
+// Advance simulated time: robots with a timing move and work up to `now` (in ticks).
+// Usually broadcast (to = kBroadcastId); a directed tick only advances one robot.
 struct TickCommand {
+    RobotId            to{0};
     unsigned long long now{0};
 };
 
+// -------------------------
+// In-memory layout
+// -------------------------
+// Every message is a fixed-size, trivially copyable value, so it can be memcpy'd into ring
+// buffers or shared memory between threads/processes built with the same ABI.
+static_assert(std::is_trivially_copyable_v<DetectionEvent>);
+static_assert(std::is_trivially_copyable_v<StatusEvent>);
+static_assert(std::is_trivially_copyable_v<WorkCompletedEvent>);
+static_assert(std::is_trivially_copyable_v<MoveCommand>);
+static_assert(std::is_trivially_copyable_v<StartWorkCommand>);
+static_assert(std::is_trivially_copyable_v<StopCommand>);
+static_assert(std::is_trivially_copyable_v<TickCommand>);
+static_assert(sizeof(RobotId) == 4 && sizeof(Position) == 8);
+static_assert(sizeof(RobotType) == 1 && sizeof(RobotState) == 1 && sizeof(WorkKind) == 1);
+static_assert(sizeof(DetectionEvent) == 12);
+static_assert(sizeof(StatusEvent) == 16 && offsetof(StatusEvent, position) == 8);
+static_assert(sizeof(WorkCompletedEvent) == 16 && offsetof(WorkCompletedEvent, position) == 8);
+static_assert(sizeof(MoveCommand) == 12);
+static_assert(sizeof(StartWorkCommand) == 8);
+static_assert(sizeof(StopCommand) == 4);
+static_assert(sizeof(TickCommand) == 16 && offsetof(TickCommand, now) == 8);
+
+// -------------------------
+// Binary wire format
+// -------------------------
+// ABI-independent encoding for logs and cross-process transport. A frame is a 1-byte
+// MessageTag followed by the fields in declaration order, little-endian, without padding:
+//   RobotId i32 | Position x i32, y i32 | RobotType/RobotState/WorkKind u8 | bool u8 | u64
+//
+//   DetectionEvent     tag from position                  13 bytes
+//   StatusEvent        tag from type state position       15 bytes
+//   WorkCompletedEvent tag from workKind success position 15 bytes
+//   MoveCommand        tag to position                    13 bytes
+//   StartWorkCommand   tag to kind                         6 bytes
+//   StopCommand        tag to                              5 bytes
+//   TickCommand        tag to now                         13 bytes
+enum class MessageTag : std::uint8_t {
+    DETECTION = 1, STATUS, WORK_COMPLETED, MOVE, START_WORK, STOP, TICK
+};
+
+// upper bound of any frame, suitable for fixed-size slots
+constexpr std::size_t kMaxWireSize = 16;
+
+// encode into `buf` (at least kMaxWireSize bytes), returns the frame size
+std::size_t encode(const DetectionEvent&, std::uint8_t* buf);
+std::size_t encode(const StatusEvent&, std::uint8_t* buf);
+std::size_t encode(const WorkCompletedEvent&, std::uint8_t* buf);
+std::size_t encode(const MoveCommand&, std::uint8_t* buf);
+std::size_t encode(const StartWorkCommand&, std::uint8_t* buf);
+std::size_t encode(const StopCommand&, std::uint8_t* buf);
+std::size_t encode(const TickCommand&, std::uint8_t* buf);
+
+// tag of the frame in `buf`; false if `len` is 0 or the tag is unknown
+bool peekTag(const std::uint8_t* buf, std::size_t len, MessageTag& out);
+
+// decode one frame; false if the tag does not match, the frame is short or a field is out of range
+bool decode(const std::uint8_t* buf, std::size_t len, DetectionEvent& out);
+bool decode(const std::uint8_t* buf, std::size_t len, StatusEvent& out);
+bool decode(const std::uint8_t* buf, std::size_t len, WorkCompletedEvent& out);
+bool decode(const std::uint8_t* buf, std::size_t len, MoveCommand& out);
+bool decode(const std::uint8_t* buf, std::size_t len, StartWorkCommand& out);
+bool decode(const std::uint8_t* buf, std::size_t len, StopCommand& out);
+bool decode(const std::uint8_t* buf, std::size_t len, TickCommand& out);
+
 // -------------------------
 // Simple string helpers
 // -------------------------
+const char* workKindName(WorkKind);           // "DETECT" / "VACUUM" / "WASH" / "NONE"
+
+// Allocation-free formatting into a caller-provided buffer: writes at most `size` characters
+// (no terminating NUL, output is truncated if the buffer is too small) and returns the count.
+// kMaxMessageText is always enough for a complete line.
+constexpr std::size_t kMaxMessageText = 96;
+std::size_t toChars(const DetectionEvent&, char* buf, std::size_t size);
+std::size_t toChars(const StatusEvent&, char* buf, std::size_t size);
+std::size_t toChars(const WorkCompletedEvent&, char* buf, std::size_t size);
+std::size_t toChars(const MoveCommand&, char* buf, std::size_t size);
+std::size_t toChars(const StartWorkCommand&, char* buf, std::size_t size);
+std::size_t toChars(const StopCommand&, char* buf, std::size_t size);
+std::size_t toChars(const TickCommand&, char* buf, std::size_t size);
+
+// Same text as toChars, as an owning string
+std::string toString(WorkKind);
 std::string toString(const DetectionEvent&);
 std::string toString(const StatusEvent&);
 std::string toString(const WorkCompletedEvent&);
@@ -0,0 +1,151 @@
+#include "planner/assignment.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/idle_robot_index.hpp"
+
+std::vector<Assignment> assignTargets(const std::vector<Position>& robots, const std::vector<Position>& targets) {
+    if (robots.size() <= kHungarianLimit && targets.size() <= kHungarianLimit) {
+        return hungarianAssign(robots, targets);
+    }
+    return greedyRepairAssign(robots, targets);
+}
+
+std::vector<Assignment> hungarianAssign(const std::vector<Position>& robots, const std::vector<Position>& targets) {
+    if (robots.empty() || targets.empty()) {
+        return {};
+    }
+    // rows must not outnumber columns - put the smaller side on the rows
+    const bool robotsAreRows = robots.size() <= targets.size();
+    const std::vector<Position>& rows = robotsAreRows ? robots : targets;
+    const std::vector<Position>& cols = robotsAreRows ? targets : robots;
+    const std::size_t n = rows.size();
+    const std::size_t m = cols.size();
+    auto cost = [&](std::size_t r, std::size_t c) -> long long { return manhattan(rows[r - 1], cols[c - 1]); };
+
+    // potentials u (rows), v (columns); match[c] = row matched to column c (1-based, 0 = none)
+    const long long inf = std::numeric_limits<long long>::max() / 4;
+    std::vector<long long> u(n + 1, 0), v(m + 1, 0);
+    std::vector<std::size_t> match(m + 1, 0), way(m + 1, 0);
+    for (std::size_t row = 1; row <= n; ++row) {
+        match[0] = row;
+        std::size_t col0 = 0;
+        std::vector<long long> minv(m + 1, inf);
+        std::vector<bool> used(m + 1, false);
+        do {
+            used[col0] = true;
+            const std::size_t row0 = match[col0];
+            long long delta = inf;
+            std::size_t col1 = 0;
+            for (std::size_t c = 1; c <= m; ++c) {
+                if (used[c]) {
+                    continue;
+                }
+                const long long reduced = cost(row0, c) - u[row0] - v[c];
+                if (reduced < minv[c]) {
+                    minv[c] = reduced;
+                    way[c] = col0;
+                }
+                if (minv[c] < delta) {
+                    delta = minv[c];
+                    col1 = c;
+                }
+            }
+            for (std::size_t c = 0; c <= m; ++c) {
+                if (used[c]) {
+                    u[match[c]] += delta;
+                    v[c] -= delta;
+                } else {
+                    minv[c] -= delta;
+                }
+            }
+            col0 = col1;
+        } while (match[col0] != 0);
+        // augment along the alternating path
+        do {
+            const std::size_t col1 = way[col0];
+            match[col0] = match[col1];
+            col0 = col1;
+        } while (col0 != 0);
+    }
+
+    std::vector<Assignment> result;
+    result.reserve(n);
+    for (std::size_t c = 1; c <= m; ++c) {
+        if (match[c] == 0) {
+            continue;
+        }
+        const std::size_t r = match[c] - 1;
+        const std::size_t robot = robotsAreRows ? r : c - 1;
+        const std::size_t target = robotsAreRows ? c - 1 : r;
+        result.push_back(Assignment{robot, target, manhattan(robots[robot], targets[target])});
+    }
+    std::sort(result.begin(), result.end(), [](const Assignment& a, const Assignment& b) { return a.target < b.target; });
+    return result;
+}
+
+std::vector<Assignment> greedyRepairAssign(const std::vector<Position>& robots, const std::vector<Position>& targets) {
+    std::vector<Assignment> result;
+    if (robots.empty() || targets.empty()) {
+        return result;
+    }
+
+    // greedy pass: each target, in queue order, takes its nearest free robot
+    IdleRobotIndex freeRobots;
+    for (std::size_t i = 0; i < robots.size(); ++i) {
+        freeRobots.insert(static_cast<RobotId>(i), robots[i]);
+    }
+    result.reserve(std::min(robots.size(), targets.size()));
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        RobotId robot = 0;
+        if (!freeRobots.nearest(targets[t], robot)) {
+            break;
+        }
+        freeRobots.remove(robot);
+        const auto r = static_cast<std::size_t>(robot);
+        result.push_back(Assignment{r, t, manhattan(robots[r], targets[t])});
+    }
+
+    // repair pass: sort by target location so that spatial neighbours are adjacent, then swap
+    // robots between assignments within a small window while that shortens the total distance
+    std::sort(result.begin(), result.end(), [&](const Assignment& a, const Assignment& b) {
+        const Position pa = targets[a.target];
+        const Position pb = targets[b.target];
+        return pa.y != pb.y ? pa.y < pb.y : pa.x < pb.x;
+    });
+    const std::size_t window = 16;
+    const int maxPasses = 4;
+    for (int pass = 0; pass < maxPasses; ++pass) {
+        bool improved = false;
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            const std::size_t last = std::min(result.size(), i + 1 + window);
+            for (std::size_t j = i + 1; j < last; ++j) {
+                Assignment& a = result[i];
+                Assignment& b = result[j];
+                const int swappedA = manhattan(robots[b.robot], targets[a.target]);
+                const int swappedB = manhattan(robots[a.robot], targets[b.target]);
+                if (swappedA + swappedB < a.distance + b.distance) {
+                    std::swap(a.robot, b.robot);
+                    a.distance = swappedA;
+                    b.distance = swappedB;
+                    improved = true;
+                }
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const Assignment& a, const Assignment& b) { return a.target < b.target; });
+    return result;
+}
+
+long long totalDistance(const std::vector<Assignment>& assignments) {
+    long long total = 0;
+    for (const auto& a : assignments) {
+        total += a.distance;
+    }
+    return total;
+}
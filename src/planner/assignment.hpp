@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "common/types.hpp"
+
+// Min-total-distance matching of idle robots to queued targets (Manhattan distance).
+// Each robot takes at most one target and each target at most one robot; min(robots, targets)
+// pairs are produced.
+
+struct Assignment {
+    std::size_t robot;   // index into the robots vector
+    std::size_t target;  // index into the targets vector
+    int         distance;
+};
+
+// Batches up to this many rows x columns are solved exactly, larger ones heuristically.
+constexpr std::size_t kHungarianLimit = 128;
+
+// Picks the exact solver for small batches and greedy-with-repair for large ones.
+std::vector<Assignment> assignTargets(const std::vector<Position>& robots, const std::vector<Position>& targets);
+
+// Exact Hungarian algorithm, O(n^2 * m) for n = min(robots, targets), m = max(robots, targets).
+std::vector<Assignment> hungarianAssign(const std::vector<Position>& robots, const std::vector<Position>& targets);
+
+// Targets in order grab their nearest free robot, then pairwise swaps between neighbouring
+// assignments are applied while they shorten the total distance.
+std::vector<Assignment> greedyRepairAssign(const std::vector<Position>& robots, const std::vector<Position>& targets);
+
+// Sum of the distances of a set of assignments.
+long long totalDistance(const std::vector<Assignment>& assignments);
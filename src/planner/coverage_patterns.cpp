@@ -0,0 +1,253 @@
+#include "planner/coverage_patterns.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+// ---- index-based patterns: the i-th cell is computed directly from the cursor ----
+
+class IndexedPattern : public CoveragePattern {
+public:
+    explicit IndexedPattern(const Region& region) : region_(region) {}
+
+    bool next(Position& out) override {
+        if (index_ >= region_.cellCount()) {
+            return false;
+        }
+        out = at(index_++);
+        return true;
+    }
+    std::size_t skip(std::size_t n) override {
+        const std::size_t skipped = std::min(n, region_.cellCount() - std::min(index_, region_.cellCount()));
+        index_ += skipped;
+        return skipped;
+    }
+
+protected:
+    virtual Position at(std::size_t index) const = 0;
+
+    Region      region_;
+    std::size_t index_{0};
+};
+
+class RowWisePattern final : public IndexedPattern {
+public:
+    using IndexedPattern::IndexedPattern;
+
+protected:
+    Position at(std::size_t index) const override {
+        const auto w = static_cast<std::size_t>(region_.width());
+        return Position{region_.x0 + static_cast<int>(index % w), region_.y0 + static_cast<int>(index / w)};
+    }
+};
+
+class ColumnWisePattern final : public IndexedPattern {
+public:
+    using IndexedPattern::IndexedPattern;
+
+protected:
+    Position at(std::size_t index) const override {
+        const auto h = static_cast<std::size_t>(region_.height());
+        return Position{region_.x0 + static_cast<int>(index / h), region_.y0 + static_cast<int>(index % h)};
+    }
+};
+
+// rows alternate direction, so consecutive cells are always neighbours
+class SerpentinePattern final : public IndexedPattern {
+public:
+    using IndexedPattern::IndexedPattern;
+
+protected:
+    Position at(std::size_t index) const override {
+        const auto w = static_cast<std::size_t>(region_.width());
+        const auto row = static_cast<int>(index / w);
+        const auto offset = static_cast<int>(index % w);
+        const int x = (row % 2 == 0) ? offset : region_.width() - 1 - offset;
+        return Position{region_.x0 + x, region_.y0 + row};
+    }
+};
+
+// ---- stateful patterns ----
+
+// clockwise, peeling one ring at a time
+class SpiralPattern final : public CoveragePattern {
+public:
+    explicit SpiralPattern(const Region& region)
+        : left_(region.x0), top_(region.y0), right_(region.x1 - 1), bottom_(region.y1 - 1),
+          x_(region.x0), y_(region.y0), remaining_(region.cellCount()) {}
+
+    bool next(Position& out) override {
+        if (remaining_ == 0) {
+            return false;
+        }
+        out = Position{x_, y_};
+        --remaining_;
+        advance();
+        return true;
+    }
+
+private:
+    void advance() {
+        if (remaining_ == 0) {
+            return;
+        }
+        // turn when the current side is exhausted, shrinking the bounds behind us
+        for (;;) {
+            switch (dir_) {
+            case 0: if (x_ < right_)  { ++x_; return; } ++top_;    dir_ = 1; break;   // east
+            case 1: if (y_ < bottom_) { ++y_; return; } --right_;  dir_ = 2; break;   // south
+            case 2: if (x_ > left_)   { --x_; return; } --bottom_; dir_ = 3; break;   // west
+            default: if (y_ > top_)   { --y_; return; } ++left_;   dir_ = 0; break;   // north
+            }
+        }
+    }
+
+    int left_, top_, right_, bottom_;
+    int x_, y_;
+    int dir_{0};
+    std::size_t remaining_;
+};
+
+// Visits square tiles of `side` cells in serpentine tile order; cells inside a tile come from
+// cellInTile(tileIndex), and cells that fall outside the region (edge tiles) are skipped.
+class TiledPattern : public CoveragePattern {
+public:
+    TiledPattern(const Region& region, int side)
+        : region_(region), side_(std::max(side, 1)),
+          tilesX_(region.empty() ? 0 : (region.width() + side_ - 1) / side_),
+          tilesY_(region.empty() ? 0 : (region.height() + side_ - 1) / side_) {}
+
+    bool next(Position& out) override {
+        const std::size_t tileCells = static_cast<std::size_t>(side_) * static_cast<std::size_t>(side_);
+        const std::size_t tiles = static_cast<std::size_t>(tilesX_) * static_cast<std::size_t>(tilesY_);
+        while (tile_ < tiles) {
+            while (inTile_ < tileCells) {
+                const Position local = cellInTile(inTile_++, tileReversed());
+                const Position cell{origin().x + local.x, origin().y + local.y};
+                if (cell.x < region_.x1 && cell.y < region_.y1) {
+                    out = cell;
+                    return true;
+                }
+            }
+            ++tile_;
+            inTile_ = 0;
+        }
+        return false;
+    }
+
+protected:
+    // i-th cell of a side x side tile; `reversed` tiles are walked right-to-left so that
+    // consecutive tiles in a serpentine row connect on the shared edge
+    virtual Position cellInTile(std::size_t index, bool reversed) const = 0;
+    int side() const { return side_; }
+
+private:
+    bool tileReversed() const { return (tile_ / static_cast<std::size_t>(tilesX_)) % 2 == 1; }
+    Position origin() const {
+        const auto row = static_cast<int>(tile_ / static_cast<std::size_t>(tilesX_));
+        const auto col = static_cast<int>(tile_ % static_cast<std::size_t>(tilesX_));
+        const int tx = (row % 2 == 0) ? col : tilesX_ - 1 - col;
+        return Position{region_.x0 + tx * side_, region_.y0 + row * side_};
+    }
+
+    Region      region_;
+    int         side_;
+    int         tilesX_;
+    int         tilesY_;
+    std::size_t tile_{0};
+    std::size_t inTile_{0};
+};
+
+// serpentine inside fixed-size tiles
+class RegionSplitPattern final : public TiledPattern {
+public:
+    explicit RegionSplitPattern(const Region& region) : TiledPattern(region, 8) {}
+
+protected:
+    Position cellInTile(std::size_t index, bool reversed) const override {
+        const auto row = static_cast<int>(index / static_cast<std::size_t>(side()));
+        const auto offset = static_cast<int>(index % static_cast<std::size_t>(side()));
+        const int x = ((row % 2 == 0) != reversed) ? offset : side() - 1 - offset;
+        return Position{x, row};
+    }
+};
+
+// largest power of two not exceeding n (n >= 1)
+int floorPow2(int n) {
+    int p = 1;
+    while (p <= n / 2) {
+        p *= 2;
+    }
+    return p;
+}
+
+// Hilbert curve inside power-of-two tiles sized to the shorter side of the region
+class HilbertPattern final : public TiledPattern {
+public:
+    explicit HilbertPattern(const Region& region)
+        : TiledPattern(region, region.empty() ? 1 : floorPow2(std::min(region.width(), region.height()))) {}
+
+protected:
+    Position cellInTile(std::size_t index, bool reversed) const override {
+        // classic d -> (x, y) conversion
+        int x = 0;
+        int y = 0;
+        std::size_t t = index;
+        for (int s = 1; s < side(); s *= 2) {
+            const int rx = static_cast<int>((t / 2) & 1u);
+            const int ry = static_cast<int>((t ^ static_cast<std::size_t>(rx)) & 1u);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+            x += s * rx;
+            y += s * ry;
+            t /= 4;
+        }
+        // the curve runs from (0,0) to (side-1,0); mirror it for right-to-left tile rows
+        return Position{reversed ? side() - 1 - x : x, y};
+    }
+};
+
+template<typename Pattern>
+std::unique_ptr<CoveragePattern> make(const Region& region) {
+    return std::make_unique<Pattern>(region);
+}
+
+}
+
+const PatternRegistry& PatternRegistry::builtin() {
+    static const PatternRegistry registry = [] {
+        PatternRegistry r;
+        r.add("row-wise", &make<RowWisePattern>);
+        r.add("column-wise", &make<ColumnWisePattern>);
+        r.add("serpentine", &make<SerpentinePattern>);
+        r.add("spiral", &make<SpiralPattern>);
+        r.add("hilbert", &make<HilbertPattern>);
+        r.add("region-split", &make<RegionSplitPattern>);
+        return r;
+    }();
+    return registry;
+}
+
+std::unique_ptr<CoveragePattern> PatternRegistry::create(const std::string& name, const Region& region) const {
+    auto it = factories_.find(name);
+    if (it == factories_.end()) {
+        return nullptr;
+    }
+    return it->second(region);
+}
+
+std::vector<std::string> PatternRegistry::names() const {
+    std::vector<std::string> result;
+    result.reserve(factories_.size());
+    for (const auto& [name, factory] : factories_) {
+        (void)factory;
+        result.push_back(name);
+    }
+    return result;
+}
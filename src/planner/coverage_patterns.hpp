@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/types.hpp"
+
+// Rectangular block of cells [x0, x1) x [y0, y1).
+struct Region {
+    int x0{0}, y0{0}, x1{0}, y1{0};
+
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+    std::size_t cellCount() const {
+        return empty() ? 0 : static_cast<std::size_t>(width()) * static_cast<std::size_t>(height());
+    }
+    bool empty() const { return x1 <= x0 || y1 <= y0; }
+};
+
+// A coverage pattern visits every cell of its region exactly once, producing cells lazily.
+class CoveragePattern {
+public:
+    virtual ~CoveragePattern() = default;
+    // write the next cell into `out`; false once the whole region has been visited
+    virtual bool next(Position& out) = 0;
+    // move past the next `n` cells without producing them; returns how many were skipped
+    // (fewer once the region runs out). The default walks next(), index-based patterns jump.
+    virtual std::size_t skip(std::size_t n) {
+        Position cell;
+        std::size_t skipped = 0;
+        while (skipped < n && next(cell)) {
+            ++skipped;
+        }
+        return skipped;
+    }
+};
+
+using PatternFactory = std::unique_ptr<CoveragePattern> (*)(const Region& region);
+
+// Name -> pattern factory table. builtin() holds the patterns shipped with the planner:
+//   "row-wise", "column-wise"  rows/columns always left-to-right/top-to-bottom (jump back at each end)
+//   "serpentine"               true boustrophedon, alternating direction every row
+//   "spiral"                   clockwise from the outer ring inwards
+//   "hilbert"                  Hilbert curve over power-of-two tiles, tiles visited in serpentine order
+//   "region-split"             8x8 tiles visited in serpentine order, serpentine inside each tile
+class PatternRegistry {
+public:
+    static const PatternRegistry& builtin();
+
+    // register (or replace) a pattern under `name`
+    void add(const std::string& name, PatternFactory factory) { factories_[name] = factory; }
+    bool contains(const std::string& name) const { return factories_.count(name) > 0; }
+    // nullptr if the name is unknown
+    std::unique_ptr<CoveragePattern> create(const std::string& name, const Region& region) const;
+    std::vector<std::string> names() const;
+
+private:
+    std::map<std::string, PatternFactory> factories_;
+};
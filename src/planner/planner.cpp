@@ -3,57 +3,104 @@
 #include <algorithm>
 #include <cstddef>
 
+// ---- ScanPath ----
+
+bool ScanPath::next(Position& out) {
+    if (!pattern_ || !pattern_->next(out)) {
+        return false;
+    }
+    ++visited_;
+    return true;
+}
+
+std::size_t ScanPath::skip(std::size_t n) {
+    const std::size_t skipped = pattern_ ? pattern_->skip(n) : 0;
+    visited_ += skipped;
+    return skipped;
+}
+
+// ---- Planner ----
+
 // Planner sets up grid coverage patterns for multiple detectors.
 void Planner::configureGrid(int width, int height) {
     width_ = width;
     height_ = height;
 }
 
-// Creates one scan path per detector, alternating between pattern generators.
-std::vector<std::vector<Position>> Planner::buildScanPlans(std::size_t detectorCount) const {
+bool Planner::setPatterns(const std::vector<std::string>& names) {
+    if (names.empty()) {
+        return false;
+    }
+    for (const auto& name : names) {
+        if (!registry_->contains(name)) {
+            return false;
+        }
+    }
+    patterns_ = names;
+    return true;
+}
+
+// Creates one scan path per detector over its own region, cycling through the configured patterns.
+std::vector<ScanPath> Planner::buildScanPlans(std::size_t detectorCount) const {
     if (!isConfigured() || detectorCount == 0) {
         return {};
     }
 
-    // Define available pattern generators.
-    std::vector<PatternGenerator> generators = {
-        &Planner::rowWisePattern,
-        &Planner::columnWisePattern
-    };
-
-    std::vector<std::vector<Position>> plans;
+    std::vector<Region> regions = partition(detectorCount);
+    std::vector<ScanPath> plans;
     plans.reserve(detectorCount);
 
     // Assign patterns to detectors in a round-robin fashion.
     for (std::size_t idx = 0; idx < detectorCount; ++idx) {
-        PatternGenerator generator = generators[idx % generators.size()];
-        std::vector<Position> pattern = (this->*generator)();
-        plans.push_back(std::move(pattern));
+        const std::string& pattern = patterns_[idx % patterns_.size()];
+        plans.emplace_back(regions[idx], registry_->create(pattern, regions[idx]));
     }
 
     return plans;
 }
 
-// Fill the grid row by row to produce a simple boustrophedon-like path.
-std::vector<Position> Planner::rowWisePattern() const {
-    std::vector<Position> path;
-    path.reserve(static_cast<std::size_t>(width_) * height_);
-    for (int y = 0; y < height_; ++y) {
-        for (int x = 0; x < width_; ++x) {
-            path.push_back(Position{x, y});
-        }
+std::vector<Region> Planner::partition(std::size_t count) const {
+    std::vector<Region> regions(count);
+    if (!isConfigured() || count == 0) {
+        return regions;
+    }
+
+    const bool splitColumns = width_ >= height_;
+    const int length = splitColumns ? width_ : height_;
+    const std::size_t stripes = std::min<std::size_t>(count, static_cast<std::size_t>(length));
+
+    // near-equal stripes: the first (length % stripes) get one extra line
+    int begin = 0;
+    for (std::size_t idx = 0; idx < stripes; ++idx) {
+        const int extent = length / static_cast<int>(stripes) + (static_cast<int>(idx) < length % static_cast<int>(stripes) ? 1 : 0);
+        regions[idx] = splitColumns ? Region{begin, 0, begin + extent, height_}
+                                    : Region{0, begin, width_, begin + extent};
+        begin += extent;
+    }
+    return regions;
+}
+
+std::vector<long long> Planner::planPathLengths(std::size_t detectorCount) const {
+    std::vector<ScanPath> plans = buildScanPlans(detectorCount);
+    std::vector<long long> lengths;
+    lengths.reserve(plans.size());
+    for (auto& plan : plans) {
+        lengths.push_back(pathLength(plan));
     }
-    return path;
+    return lengths;
 }
 
-// same as above, but column by column
-std::vector<Position> Planner::columnWisePattern() const {
-    std::vector<Position> path;
-    path.reserve(static_cast<std::size_t>(width_) * height_);
-    for (int x = 0; x < width_; ++x) {
-        for (int y = 0; y < height_; ++y) {
-            path.push_back(Position{x, y});
+long long Planner::pathLength(ScanPath& path) {
+    long long length = 0;
+    Position prev;
+    Position cell;
+    bool first = true;
+    while (path.next(cell)) {
+        if (!first) {
+            length += manhattan(prev, cell);
         }
+        prev = cell;
+        first = false;
     }
-    return path;
+    return length;
 }
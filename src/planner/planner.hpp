@@ -1,8 +1,34 @@
 #pragma once
 #include <cstddef>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "robot/robot.hpp"    // Position, RobotType
+#include "planner/coverage_patterns.hpp"
+
+// Lazy scan path over one region: cells are produced on demand by a coverage pattern,
+// so a path costs O(1) memory regardless of the region size.
+class ScanPath {
+public:
+    ScanPath() = default;
+    ScanPath(Region region, std::unique_ptr<CoveragePattern> pattern)
+        : region_(region), pattern_(std::move(pattern)) {}
+
+    // write the next cell into `out`; false once the whole region has been visited
+    bool next(Position& out);
+    // skip the next `n` cells (resuming a scan); returns how many were skipped
+    std::size_t skip(std::size_t n);
+    bool done() const { return visited_ >= size(); }
+    std::size_t size() const { return pattern_ ? region_.cellCount() : 0; }
+    std::size_t visited() const { return visited_; }
+    const Region& region() const { return region_; }
+
+private:
+    Region                           region_{};
+    std::unique_ptr<CoveragePattern> pattern_;
+    std::size_t                      visited_{0};
+};
 
 class Planner {
 public:
@@ -12,14 +38,26 @@ public:
     int width() const { return width_; }
     int height() const { return height_; }
 
-    std::vector<std::vector<Position>> buildScanPlans(std::size_t detectorCount) const;
+    // coverage patterns handed to detectors round-robin (default: {"serpentine"});
+    // false and unchanged if a name is not in the pattern registry
+    bool setPatterns(const std::vector<std::string>& names);
+    const std::vector<std::string>& patterns() const { return patterns_; }
 
-private:
-    using PatternGenerator = std::vector<Position> (Planner::*)() const;
+    // one lazy path per detector over disjoint regions that together cover the grid once
+    std::vector<ScanPath> buildScanPlans(std::size_t detectorCount) const;
+    // split the grid into `count` disjoint stripes along its longer axis
+    // (surplus entries are empty when there are more detectors than rows/columns)
+    std::vector<Region> partition(std::size_t count) const;
 
-    std::vector<Position> rowWisePattern() const;
-    std::vector<Position> columnWisePattern() const;
+    // total travel (Manhattan steps between consecutive cells) of each plan for the given
+    // detector count and the configured patterns
+    std::vector<long long> planPathLengths(std::size_t detectorCount) const;
+    // travel along a whole path, consuming it
+    static long long pathLength(ScanPath& path);
 
+private:
     int width_{0};
     int height_{0};
+    const PatternRegistry*   registry_{&PatternRegistry::builtin()};
+    std::vector<std::string> patterns_{"serpentine"};
 };
@@ -0,0 +1,84 @@
+#include "registry/fleet_state.hpp"
+
+#include "registry/nearest_idle_kernel.hpp"
+
+#include <cstdlib>
+
+std::size_t FleetState::add(RobotId id, RobotType type, RobotState state, Position pos) {
+    const std::size_t slot = ids_.size();
+    ids_.push_back(id);
+    types_.push_back(type);
+    states_.push_back(state);
+    xs_.push_back(pos.x);
+    ys_.push_back(pos.y);
+    if (id >= 0) {
+        if (static_cast<std::size_t>(id) >= slotOf_.size()) {
+            slotOf_.resize(static_cast<std::size_t>(id) + 1, kNoSlot);
+        }
+        slotOf_[static_cast<std::size_t>(id)] = slot;
+    }
+    return slot;
+}
+
+void FleetState::remove(std::size_t slot) {
+    if (slot >= ids_.size()) {
+        return;
+    }
+    if (ids_[slot] >= 0) {
+        slotOf_[static_cast<std::size_t>(ids_[slot])] = kNoSlot;
+    }
+    const auto at = static_cast<std::ptrdiff_t>(slot);
+    ids_.erase(ids_.begin() + at);
+    types_.erase(types_.begin() + at);
+    states_.erase(states_.begin() + at);
+    xs_.erase(xs_.begin() + at);
+    ys_.erase(ys_.begin() + at);
+    for (std::size_t i = slot; i < ids_.size(); ++i) {
+        if (ids_[i] >= 0) {
+            slotOf_[static_cast<std::size_t>(ids_[i])] = i;
+        }
+    }
+}
+
+void FleetState::clear() {
+    ids_.clear();
+    types_.clear();
+    states_.clear();
+    xs_.clear();
+    ys_.clear();
+    slotOf_.clear();
+}
+
+std::size_t FleetState::slotOf(RobotId id) const {
+    if (id < 0 || static_cast<std::size_t>(id) >= slotOf_.size()) {
+        return kNoSlot;
+    }
+    return slotOf_[static_cast<std::size_t>(id)];
+}
+
+// idleWithin is a linear pass over the columns with 64-bit distances, so that far-apart int
+// coordinates cannot overflow; nearestIdle runs the vectorized kernel.
+
+std::size_t FleetState::idleWithin(RobotType type, Position center, int maxDistance, std::vector<RobotId>& out) const {
+    out.clear();
+    const std::size_t n = ids_.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const long long distance = std::llabs(static_cast<long long>(xs_[i]) - center.x)
+                                 + std::llabs(static_cast<long long>(ys_[i]) - center.y);
+        const bool match = types_[i] == type && states_[i] == RobotState::IDLE && distance <= maxDistance;
+        if (match) {
+            out.push_back(ids_[i]);
+        }
+    }
+    return out.size();
+}
+
+bool FleetState::nearestIdle(RobotType type, Position target, RobotId& out) const {
+    const FleetColumns columns{xs_.data(), ys_.data(), types_.data(), states_.data(), ids_.size()};
+    const std::size_t slot = nearestIdleSlot(columns, type, target);
+    if (slot == kNoNearest) {
+        return false;
+    }
+    out = ids_[slot];
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/types.hpp"
+
+// Structure-of-arrays copy of every robot's type, state and position.
+//
+// Robots write their state through to their slot (see RobotBase::setState/setPosition), so
+// fleet-wide queries scan a few tightly packed arrays instead of chasing robot objects.
+// Slots are dense and keep insertion order; removing one shifts the slots behind it.
+// Each slot is written only by its own robot, so robots driven from different threads may update
+// the table concurrently, while adding or removing robots requires that no run is in progress.
+class FleetState {
+public:
+    // append a robot, returns its slot
+    std::size_t add(RobotId id, RobotType type, RobotState state, Position pos);
+    // drop a slot and close the gap
+    void remove(std::size_t slot);
+    void clear();
+
+    // write-through from the robot owning the slot
+    void setState(std::size_t slot, RobotState state) { states_[slot] = state; }
+    void setPosition(std::size_t slot, Position pos) { xs_[slot] = pos.x; ys_[slot] = pos.y; }
+
+    std::size_t size() const { return ids_.size(); }
+    // slot of a robot id, or kNoSlot
+    static constexpr std::size_t kNoSlot = static_cast<std::size_t>(-1);
+    std::size_t slotOf(RobotId id) const;
+
+    RobotId    id(std::size_t slot) const { return ids_[slot]; }
+    RobotType  type(std::size_t slot) const { return types_[slot]; }
+    RobotState state(std::size_t slot) const { return states_[slot]; }
+    Position   position(std::size_t slot) const { return {xs_[slot], ys_[slot]}; }
+
+    // raw columns, one entry per slot (types/states are bytes, positions int32)
+    const RobotId*    ids() const { return ids_.data(); }
+    const RobotType*  types() const { return types_.data(); }
+    const RobotState* states() const { return states_.data(); }
+    const std::int32_t* xs() const { return xs_.data(); }
+    const std::int32_t* ys() const { return ys_.data(); }
+
+    // ids of the idle robots of `type` within Manhattan distance `maxDistance` of `center`,
+    // in slot order; replaces the contents of `out` and returns the count
+    std::size_t idleWithin(RobotType type, Position center, int maxDistance, std::vector<RobotId>& out) const;
+    // nearest idle robot of `type` (ties go to the lowest slot), via the widest kernel the CPU
+    // supports (see nearest_idle_kernel.hpp); false if there is none. ControlUnit falls back to
+    // it when the idle index is too sparse for its ring search.
+    bool nearestIdle(RobotType type, Position target, RobotId& out) const;
+
+private:
+    std::vector<RobotId>      ids_;
+    std::vector<RobotType>    types_;
+    std::vector<RobotState>   states_;
+    std::vector<std::int32_t> xs_;
+    std::vector<std::int32_t> ys_;
+    std::vector<std::size_t>  slotOf_;   // indexed by RobotId
+};
@@ -0,0 +1,212 @@
+#include "registry/nearest_idle_kernel.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define NEAREST_IDLE_X86 1
+#endif
+
+namespace {
+
+static_assert(sizeof(RobotType) == 1 && sizeof(RobotState) == 1, "kernels load types/states as bytes");
+
+constexpr std::uint32_t kSaturated = std::numeric_limits<std::uint32_t>::max();
+
+// exact reference: 64-bit distances, cannot overflow
+std::size_t scalarExact(const FleetColumns& f, RobotType type, Position target) {
+    std::size_t best = kNoNearest;
+    long long bestDistance = std::numeric_limits<long long>::max();
+    for (std::size_t i = 0; i < f.size; ++i) {
+        if (f.types[i] != type || f.states[i] != RobotState::IDLE) {
+            continue;
+        }
+        const long long distance = std::llabs(static_cast<long long>(f.xs[i]) - target.x)
+                                 + std::llabs(static_cast<long long>(f.ys[i]) - target.y);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// the vector paths' arithmetic, one slot at a time (used for the tail after the last full vector)
+inline std::uint32_t saturatedDistance(const FleetColumns& f, std::size_t i, RobotType type, Position target) {
+    if (f.types[i] != type || f.states[i] != RobotState::IDLE) {
+        return kSaturated;
+    }
+    const std::uint32_t dx = f.xs[i] > target.x ? std::uint32_t(f.xs[i]) - std::uint32_t(target.x)
+                                                : std::uint32_t(target.x) - std::uint32_t(f.xs[i]);
+    const std::uint32_t dy = f.ys[i] > target.y ? std::uint32_t(f.ys[i]) - std::uint32_t(target.y)
+                                                : std::uint32_t(target.y) - std::uint32_t(f.ys[i]);
+    const std::uint32_t sum = dx + dy;
+    return sum < dx ? kSaturated : sum;
+}
+
+// fold the lane results and the scalar tail into one slot; kNoNearest asks for the exact path
+std::size_t finish(const FleetColumns& f, RobotType type, Position target, std::size_t tailStart,
+                   const std::uint32_t* laneBest, const std::int32_t* laneSlot, int lanes) {
+    std::uint32_t best = kSaturated;
+    std::size_t bestSlot = kNoNearest;
+    for (int lane = 0; lane < lanes; ++lane) {
+        const auto slot = static_cast<std::size_t>(laneSlot[lane]);
+        if (laneSlot[lane] >= 0 && (laneBest[lane] < best || (laneBest[lane] == best && slot < bestSlot))) {
+            best = laneBest[lane];
+            bestSlot = slot;
+        }
+    }
+    for (std::size_t i = tailStart; i < f.size; ++i) {
+        const std::uint32_t distance = saturatedDistance(f, i, type, target);
+        if (distance < best) {
+            best = distance;
+            bestSlot = i;
+        }
+    }
+    return best == kSaturated ? kNoNearest : bestSlot;
+}
+
+#ifdef NEAREST_IDLE_X86
+
+// Unsigned 32-bit compares are done as signed compares on values with the sign bit flipped.
+
+__attribute__((target("sse4.1")))
+std::size_t sse41(const FleetColumns& f, RobotType type, Position target) {
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i tx = _mm_set1_epi32(target.x);
+    const __m128i ty = _mm_set1_epi32(target.y);
+    const __m128i wantType = _mm_set1_epi32(static_cast<int>(type));
+    const __m128i idle = _mm_set1_epi32(static_cast<int>(RobotState::IDLE));
+    const __m128i four = _mm_set1_epi32(4);
+
+    __m128i bestBiased = _mm_set1_epi32(0x7fffffff);   // kSaturated, biased
+    __m128i bestSlot = _mm_set1_epi32(-1);
+    __m128i slot = _mm_setr_epi32(0, 1, 2, 3);
+
+    std::size_t i = 0;
+    for (; i + 4 <= f.size; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(f.xs + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(f.ys + i));
+        std::int32_t typeBytes, stateBytes;
+        std::memcpy(&typeBytes, f.types + i, 4);
+        std::memcpy(&stateBytes, f.states + i, 4);
+        const __m128i types = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(typeBytes));
+        const __m128i states = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(stateBytes));
+        const __m128i match = _mm_and_si128(_mm_cmpeq_epi32(types, wantType), _mm_cmpeq_epi32(states, idle));
+
+        const __m128i dx = _mm_sub_epi32(_mm_max_epi32(x, tx), _mm_min_epi32(x, tx));
+        const __m128i dy = _mm_sub_epi32(_mm_max_epi32(y, ty), _mm_min_epi32(y, ty));
+        const __m128i sum = _mm_add_epi32(dx, dy);
+        const __m128i overflow = _mm_cmpgt_epi32(_mm_xor_si128(dx, bias), _mm_xor_si128(sum, bias));
+        const __m128i distance = _mm_or_si128(_mm_or_si128(sum, overflow), _mm_andnot_si128(match, _mm_set1_epi32(-1)));
+
+        const __m128i biased = _mm_xor_si128(distance, bias);
+        const __m128i better = _mm_cmpgt_epi32(bestBiased, biased);
+        bestBiased = _mm_blendv_epi8(bestBiased, biased, better);
+        bestSlot = _mm_blendv_epi8(bestSlot, slot, better);
+        slot = _mm_add_epi32(slot, four);
+    }
+
+    alignas(16) std::uint32_t laneBest[4];
+    alignas(16) std::int32_t laneSlot[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(laneBest), _mm_xor_si128(bestBiased, bias));
+    _mm_store_si128(reinterpret_cast<__m128i*>(laneSlot), bestSlot);
+    return finish(f, type, target, i, laneBest, laneSlot, 4);
+}
+
+__attribute__((target("avx2")))
+std::size_t avx2(const FleetColumns& f, RobotType type, Position target) {
+    const __m256i bias = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i tx = _mm256_set1_epi32(target.x);
+    const __m256i ty = _mm256_set1_epi32(target.y);
+    const __m256i wantType = _mm256_set1_epi32(static_cast<int>(type));
+    const __m256i idle = _mm256_set1_epi32(static_cast<int>(RobotState::IDLE));
+    const __m256i eight = _mm256_set1_epi32(8);
+
+    __m256i bestBiased = _mm256_set1_epi32(0x7fffffff);
+    __m256i bestSlot = _mm256_set1_epi32(-1);
+    __m256i slot = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    std::size_t i = 0;
+    for (; i + 8 <= f.size; i += 8) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f.xs + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(f.ys + i));
+        const __m256i types = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(f.types + i)));
+        const __m256i states = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(f.states + i)));
+        const __m256i match = _mm256_and_si256(_mm256_cmpeq_epi32(types, wantType), _mm256_cmpeq_epi32(states, idle));
+
+        const __m256i dx = _mm256_sub_epi32(_mm256_max_epi32(x, tx), _mm256_min_epi32(x, tx));
+        const __m256i dy = _mm256_sub_epi32(_mm256_max_epi32(y, ty), _mm256_min_epi32(y, ty));
+        const __m256i sum = _mm256_add_epi32(dx, dy);
+        const __m256i overflow = _mm256_cmpgt_epi32(_mm256_xor_si256(dx, bias), _mm256_xor_si256(sum, bias));
+        const __m256i distance = _mm256_or_si256(_mm256_or_si256(sum, overflow),
+                                                 _mm256_andnot_si256(match, _mm256_set1_epi32(-1)));
+
+        const __m256i biased = _mm256_xor_si256(distance, bias);
+        const __m256i better = _mm256_cmpgt_epi32(bestBiased, biased);
+        bestBiased = _mm256_blendv_epi8(bestBiased, biased, better);
+        bestSlot = _mm256_blendv_epi8(bestSlot, slot, better);
+        slot = _mm256_add_epi32(slot, eight);
+    }
+
+    alignas(32) std::uint32_t laneBest[8];
+    alignas(32) std::int32_t laneSlot[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(laneBest), _mm256_xor_si256(bestBiased, bias));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(laneSlot), bestSlot);
+    return finish(f, type, target, i, laneBest, laneSlot, 8);
+}
+
+#endif  // NEAREST_IDLE_X86
+
+bool supported(KernelPath path) {
+#ifdef NEAREST_IDLE_X86
+    switch (path) {
+    case KernelPath::AVX2:   return __builtin_cpu_supports("avx2");
+    case KernelPath::SSE41:  return __builtin_cpu_supports("sse4.1");
+    case KernelPath::SCALAR: return true;
+    }
+    return false;
+#else
+    return path == KernelPath::SCALAR;
+#endif
+}
+
+}  // namespace
+
+KernelPath bestKernelPath() {
+    static const KernelPath best = supported(KernelPath::AVX2)  ? KernelPath::AVX2
+                                 : supported(KernelPath::SSE41) ? KernelPath::SSE41
+                                                                : KernelPath::SCALAR;
+    return best;
+}
+
+const char* kernelPathName(KernelPath path) {
+    switch (path) {
+    case KernelPath::AVX2:   return "avx2";
+    case KernelPath::SSE41:  return "sse4.1";
+    case KernelPath::SCALAR: break;
+    }
+    return "scalar";
+}
+
+std::size_t nearestIdleSlot(const FleetColumns& fleet, RobotType type, Position target, KernelPath path) {
+    // paths are ordered by width and every wider one implies the narrower ones
+    if (path > bestKernelPath()) {
+        path = bestKernelPath();
+    }
+    std::size_t slot = kNoNearest;
+#ifdef NEAREST_IDLE_X86
+    if (path == KernelPath::AVX2) {
+        slot = avx2(fleet, type, target);
+    } else if (path == KernelPath::SSE41) {
+        slot = sse41(fleet, type, target);
+    }
+#endif
+    if (path == KernelPath::SCALAR || slot == kNoNearest) {
+        // no match at all, or the best 32-bit distance saturated - settle it exactly
+        slot = scalarExact(fleet, type, target);
+    }
+    return slot;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "common/types.hpp"
+
+// Nearest-idle-robot search over the FleetState columns: Manhattan distance to `target` for
+// every slot whose type matches and whose state is IDLE, and the argmin (ties -> lowest slot).
+//
+// The vector paths work on eight (AVX2) or four (SSE4.1) slots per step with 32-bit distances
+// that saturate on overflow; if the best distance saturated, the search is redone with the
+// exact 64-bit scalar path, so every path returns the same slot.
+
+enum class KernelPath : std::uint8_t { SCALAR, SSE41, AVX2 };
+
+// widest path the running CPU supports (decided once)
+KernelPath bestKernelPath();
+const char* kernelPathName(KernelPath path);
+
+struct FleetColumns {
+    const std::int32_t* xs;
+    const std::int32_t* ys;
+    const RobotType*    types;
+    const RobotState*   states;
+    std::size_t         size;
+};
+
+constexpr std::size_t kNoNearest = static_cast<std::size_t>(-1);
+
+// slot of the nearest idle robot of `type`, or kNoNearest; an unsupported path falls back to SCALAR
+std::size_t nearestIdleSlot(const FleetColumns& fleet, RobotType type, Position target,
+                            KernelPath path = bestKernelPath());
@@ -1,44 +1,73 @@
 #include "registry/registry.hpp"
 
+RobotRegistry::~RobotRegistry() {
+    // robots may outlive the registry - stop them writing into the table
+    for (RobotBase* robot : all_) {
+        robot->attachFleet(nullptr, 0);
+    }
+}
+
 bool RobotRegistry::add(std::shared_ptr<RobotBase> r) {
-    if (!r) {
+    if (!r || r->id() <= kBroadcastId) {
+        return false;
+    }
+    const auto id = static_cast<std::size_t>(r->id());
+    if (id >= byId_.size()) {
+        byId_.resize(id + 1);
+    }
+    Slot& slot = byId_[id];
+    if (slot.owner) {
         return false;
     }
-    const RobotId id = r->id();
-    const RobotType type = r->type();
 
-    auto [it, inserted] = robots_by_id_.emplace(id, std::move(r));
-    if (!inserted) {
+    auto& typed = byType_[static_cast<std::size_t>(r->type())];
+    slot.allIndex = all_.size();
+    slot.typeIndex = typed.size();
+    all_.push_back(r.get());
+    typed.push_back(r.get());
+    r->attachFleet(&fleet_, fleet_.add(r->id(), r->type(), r->state(), r->position()));
+    slot.owner = std::move(r);
+    return true;
+}
+
+bool RobotRegistry::remove(RobotId id) {
+    RobotBase* robot = find(id);
+    if (!robot) {
         return false;
     }
+    Slot& slot = byId_[static_cast<std::size_t>(id)];
+    robot->attachFleet(nullptr, 0);
+    fleet_.remove(slot.allIndex);
+    eraseAt(all_, slot.allIndex);
+    eraseAt(byType_[static_cast<std::size_t>(robot->type())], slot.typeIndex);
 
-    robots_by_type_[type].push_back(it->second);
+    // the robots behind the gap moved one place forward
+    for (std::size_t i = slot.allIndex; i < all_.size(); ++i) {
+        byId_[static_cast<std::size_t>(all_[i]->id())].allIndex = i;
+        all_[i]->attachFleet(&fleet_, i);
+    }
+    const auto& typed = byType_[static_cast<std::size_t>(robot->type())];
+    for (std::size_t i = slot.typeIndex; i < typed.size(); ++i) {
+        byId_[static_cast<std::size_t>(typed[i]->id())].typeIndex = i;
+    }
+    slot = Slot{};
     return true;
 }
 
-std::shared_ptr<RobotBase> RobotRegistry::getById(RobotId id) const {
-    auto it = robots_by_id_.find(id);
-    if (it == robots_by_id_.end()) {
+RobotBase* RobotRegistry::find(RobotId id) const {
+    if (id <= kBroadcastId || static_cast<std::size_t>(id) >= byId_.size()) {
         return nullptr;
     }
-    return it->second;
+    return byId_[static_cast<std::size_t>(id)].owner.get();
 }
 
-std::vector<std::shared_ptr<RobotBase>> RobotRegistry::getByType(RobotType t) const {
-    auto it = robots_by_type_.find(t);
-    if (it == robots_by_type_.end()) {
-        return {};
+std::shared_ptr<RobotBase> RobotRegistry::getById(RobotId id) const {
+    if (!find(id)) {
+        return nullptr;
     }
-
-    return it->second;
+    return byId_[static_cast<std::size_t>(id)].owner;
 }
 
-std::vector<std::shared_ptr<RobotBase>> RobotRegistry::getAll() const {
-    std::vector<std::shared_ptr<RobotBase>> result;
-    result.reserve(robots_by_id_.size());
-    for (const auto& [id, robot] : robots_by_id_) {
-        (void)id;
-        result.push_back(robot);
-    }
-    return result;
+void RobotRegistry::eraseAt(std::vector<RobotBase*>& robots, std::size_t index) {
+    robots.erase(robots.begin() + static_cast<std::ptrdiff_t>(index));
 }
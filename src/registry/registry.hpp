@@ -1,18 +1,74 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
+#include "registry/fleet_state.hpp"
 #include "robot/robot.hpp"
 
+// Non-owning view over a contiguous run of robots inside a RobotRegistry. Iterating yields
+// RobotBase* without allocating or touching reference counts; any add/remove invalidates it.
+class RobotRange {
+public:
+    using iterator = RobotBase* const*;
+
+    RobotRange() = default;
+    RobotRange(iterator first, iterator last) : first_(first), last_(last) {}
+
+    iterator begin() const { return first_; }
+    iterator end() const { return last_; }
+    std::size_t size() const { return static_cast<std::size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    RobotBase* operator[](std::size_t i) const { return first_[i]; }
+
+private:
+    iterator first_{nullptr};
+    iterator last_{nullptr};
+};
+
+// Owns the fleet. Robots are kept in dense arrays: all robots in insertion order, the robots of
+// each type in insertion order, and a table indexed directly by RobotId for O(1) lookups.
+// The registry also owns the FleetState table its robots write through to (slot == position in all()).
 class RobotRegistry {
 public:
+    RobotRegistry() = default;
+    RobotRegistry(const RobotRegistry&) = delete;
+    RobotRegistry& operator=(const RobotRegistry&) = delete;
+    ~RobotRegistry();
+
     bool add(std::shared_ptr<RobotBase> r);
+    // removes the robot and closes the gap (the remaining robots keep their relative order);
+    // buses built from this registry must detach it first (ControlUnit::removeRobot does both).
+    // False if the id is unknown.
+    bool remove(RobotId id);
+
+    // O(1) lookup; nullptr if the id is unknown
+    RobotBase* find(RobotId id) const;
+    // shared ownership of a robot, for callers that keep it beyond the registry's lifetime
     std::shared_ptr<RobotBase> getById(RobotId id) const;
-    std::vector<std::shared_ptr<RobotBase>> getByType(RobotType t) const;
-    std::vector<std::shared_ptr<RobotBase>> getAll() const;
+
+    RobotRange all() const { return {all_.data(), all_.data() + all_.size()}; }
+    RobotRange ofType(RobotType t) const {
+        const auto& robots = byType_[static_cast<std::size_t>(t)];
+        return {robots.data(), robots.data() + robots.size()};
+    }
+    std::size_t size() const { return all_.size(); }
+    const FleetState& fleet() const { return fleet_; }
 
 private:
-    std::unordered_map<RobotId, std::shared_ptr<RobotBase>> robots_by_id_;
-    std::unordered_map<RobotType, std::vector<std::shared_ptr<RobotBase>>> robots_by_type_;
+    static constexpr std::size_t kTypeCount = 3;
+
+    struct Slot {
+        std::shared_ptr<RobotBase> owner;   // nullptr for unused ids
+        std::size_t allIndex{0};            // position in all_
+        std::size_t typeIndex{0};           // position in byType_[type]
+    };
+
+    static void eraseAt(std::vector<RobotBase*>& robots, std::size_t index);
+
+    std::vector<Slot> byId_;   // indexed by RobotId
+    std::vector<RobotBase*> all_;
+    std::array<std::vector<RobotBase*>, kTypeCount> byType_;
+    FleetState fleet_;
 };
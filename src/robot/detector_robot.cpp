@@ -1,27 +1,22 @@
 #include "robot/detector_robot.hpp"
 
-#include <iostream>
+#include "logging/log.hpp"
 
 void DetectorRobot::moveTo(Position dst) {
     if (state_ != RobotState::IDLE && state_ != RobotState::ARRIVED) {
-        std::cout << "[Detector#" << name_ << "] busy, ignore move\n";
+        LOG_WARN("[Detector#", name_, "] busy, ignore move");
         return;
     }
-    state_ = RobotState::MOVING;
-    pos_ = dst;
-    state_ = RobotState::ARRIVED;
-    publishStatus();
+    travelTo(dst);
 }
 
-void DetectorRobot::startWork(const std::string& kind) {
+void DetectorRobot::startWork(WorkKind kind) {
     if (state_ != RobotState::ARRIVED && state_ != RobotState::IDLE) { return; }
-    state_ = RobotState::WORKING;
-    std::cout << "[Detector#" << name_ << "] scanning for dirt\n";
-    state_ = RobotState::IDLE;
-    publishWorkCompleted(kind.empty() ? "DETECT" : kind, true);
+    LOG_DEBUG("[Detector#", name_, "] scanning for dirt");
+    performWork(kind == WorkKind::NONE ? WorkKind::DETECT : kind);
 }
 
 void DetectorRobot::stop() {
-    state_ = RobotState::IDLE;
+    setState(RobotState::IDLE);
     publishStatus();
 }
@@ -1,33 +1,117 @@
 #include "robot/robot.hpp"
 
+#include <cstdlib>
+
 #include "bus/bus.hpp"
 
 void RobotBase::attachBus(Bus* bus) {
     bus_ = bus;
 }
 
+void RobotBase::attachFleet(FleetState* fleet, std::size_t slot) {
+    fleet_ = fleet;
+    fleetSlot_ = slot;
+}
+
 void RobotBase::handle(const MoveCommand& cmd) {
-    if (cmd.to != id_) {
+    if (!addressedToMe(cmd.to)) {
         return;
     }
     moveTo(cmd.position);
 }
 
 void RobotBase::handle(const StartWorkCommand& cmd) {
-    if (cmd.to != id_) {
+    if (!addressedToMe(cmd.to)) {
         return;
     }
     startWork(cmd.kind);
 }
 
 void RobotBase::handle(const StopCommand& cmd) {
-    if (cmd.to != id_) {
+    if (!addressedToMe(cmd.to)) {
         return;
     }
     stop();
     publishStatus();
 }
 
+void RobotBase::handle(const TickCommand& cmd) {
+    if (!addressedToMe(cmd.to) || cmd.now <= now_) {
+        return;
+    }
+    const unsigned long long elapsed = cmd.now - now_;
+    now_ = cmd.now;
+    if (timing_.instant()) {
+        return;
+    }
+
+    if (state_ == RobotState::MOVING) {
+        // cover up to elapsed * speed cells, along x first, then along y
+        unsigned long long budget = elapsed * static_cast<unsigned long long>(timing_.cellsPerTick);
+        Position pos = pos_;
+        auto step = [&budget](int& from, int to) {
+            const unsigned long long gap = from < to ? static_cast<unsigned long long>(to) - from
+                                                     : static_cast<unsigned long long>(from) - to;
+            const unsigned long long moved = gap < budget ? gap : budget;
+            const long long delta = static_cast<long long>(moved);
+            from = static_cast<int>(from < to ? from + delta : from - delta);
+            budget -= moved;
+        };
+        step(pos.x, destination_.x);
+        step(pos.y, destination_.y);
+        setPosition(pos);
+        if (pos.x == destination_.x && pos.y == destination_.y) {
+            setState(RobotState::ARRIVED);
+            publishStatus();
+        }
+    } else if (state_ == RobotState::WORKING && now_ >= workDoneAt_) {
+        setState(RobotState::IDLE);
+        publishWorkCompleted(workKind_, true);
+    }
+}
+
+bool RobotBase::nextEventTime(unsigned long long& at) const {
+    if (timing_.instant()) {
+        return false;
+    }
+    if (state_ == RobotState::MOVING) {
+        const unsigned long long remaining =
+            static_cast<unsigned long long>(std::llabs(static_cast<long long>(destination_.x) - pos_.x))
+            + static_cast<unsigned long long>(std::llabs(static_cast<long long>(destination_.y) - pos_.y));
+        const auto speed = static_cast<unsigned long long>(timing_.cellsPerTick);
+        at = now_ + (remaining + speed - 1) / speed;
+        return true;
+    }
+    if (state_ == RobotState::WORKING) {
+        at = workDoneAt_;
+        return true;
+    }
+    return false;
+}
+
+void RobotBase::travelTo(Position dst) {
+    setState(RobotState::MOVING);
+    if (timing_.instant() || (pos_.x == dst.x && pos_.y == dst.y)) {
+        setPosition(dst);
+        setState(RobotState::ARRIVED);
+    } else {
+        destination_ = dst;
+    }
+    publishStatus();
+}
+
+void RobotBase::performWork(WorkKind kind) {
+    setState(RobotState::WORKING);
+    if (timing_.instant() || timing_.workTicks <= 0) {
+        setState(RobotState::IDLE);
+        publishWorkCompleted(kind, true);
+        return;
+    }
+    workKind_ = kind;
+    workDoneAt_ = now_ + static_cast<unsigned long long>(timing_.workTicks);
+    publishStatus();
+}
+
 void RobotBase::publishStatus() {
     if (!bus_) {
         return;
@@ -40,7 +124,7 @@ void RobotBase::publishStatus() {
     bus_->publish(std::move(event));
 }
 
-void RobotBase::publishWorkCompleted(const std::string& kind, bool success) {
+void RobotBase::publishWorkCompleted(WorkKind kind, bool success) {
     if (!bus_) {
         return;
     }
@@ -3,9 +3,19 @@
 #include "common/types.hpp"
 #include "common/ids.hpp"
 #include "messages/messages.hpp"
+#include "registry/fleet_state.hpp"
 
 class Bus;
 
+// How long a robot's actions take in simulated time (ticks). The default is instant: moves and
+// work complete as soon as they are commanded and TickCommands are ignored.
+struct RobotTiming {
+    int cellsPerTick{0};   // travel speed; <= 0 means instant
+    int workTicks{0};      // duration of one unit of work once arrived
+
+    bool instant() const { return cellsPerTick <= 0; }
+};
+
 // Abstract robot interface: concrete robots derive from this to interact with the bus.
 class RobotBase {
 public:
@@ -20,21 +30,51 @@ public:
 
     // API actions - to be implemented in the concrete robot classes, later to be extended with realistic logic
     virtual void moveTo(Position dst) = 0;
-    virtual void startWork(const std::string& kind) = 0;
+    virtual void startWork(WorkKind kind) = 0;
     virtual void stop() = 0;
 
     // bus interaction - called by the Bus when broadcasting commands and activating the actions above
     void attachBus(Bus* bus);
+    // fleet state table mirroring this robot's state and position (set by the registry)
+    void attachFleet(FleetState* fleet, std::size_t slot);
     void handle(const MoveCommand& cmd);
     void handle(const StartWorkCommand& cmd);
     void handle(const StopCommand& cmd);
+    // advance to simulated time cmd.now: move along toward the destination, finish due work
+    void handle(const TickCommand& cmd);
+
+    void setTiming(RobotTiming timing) { timing_ = timing; }
+    const RobotTiming& timing() const { return timing_; }
+    // absolute tick at which the current move or work will be done (timed robots that are MOVING
+    // or WORKING); false when nothing is in progress
+    bool nextEventTime(unsigned long long& at) const;
 
 protected:
     RobotBase(RobotName name, RobotType type, Position start = {}) : id_(IdGenerator::next()), name_(std::move(name)), type_(type), pos_(start) {}
 
     // event publishing helpers - to be called by derived classes when relevant events occur
     void publishStatus();
-    void publishWorkCompleted(const std::string& kind, bool success);
+    void publishWorkCompleted(WorkKind kind, bool success);
+    // shared action bodies for the concrete robots - complete at once when instant, otherwise
+    // leave the robot MOVING/WORKING and finish on a later tick
+    void travelTo(Position dst);
+    void performWork(WorkKind kind);
+
+    // state/position updates - always go through these so the fleet table stays in sync
+    void setState(RobotState state) {
+        state_ = state;
+        if (fleet_) {
+            fleet_->setState(fleetSlot_, state);
+        }
+    }
+    void setPosition(Position pos) {
+        pos_ = pos;
+        if (fleet_) {
+            fleet_->setPosition(fleetSlot_, pos);
+        }
+    }
+    // true if a command sent to `to` concerns this robot (own id or broadcast)
+    bool addressedToMe(RobotId to) const { return to == id_ || to == kBroadcastId; }
 
     RobotId id_;
     RobotName name_;
@@ -42,4 +82,13 @@ protected:
     RobotState state_{RobotState::IDLE};
     Position pos_{};
     Bus* bus_{nullptr};
+    FleetState* fleet_{nullptr};
+    std::size_t fleetSlot_{0};
+
+    // simulated time (see RobotTiming)
+    RobotTiming        timing_{};
+    unsigned long long now_{0};          // last tick seen
+    Position           destination_{};   // while MOVING
+    WorkKind           workKind_{WorkKind::NONE};
+    unsigned long long workDoneAt_{0};   // while WORKING
 };
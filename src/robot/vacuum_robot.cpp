@@ -1,28 +1,23 @@
 #include "robot/vacuum_robot.hpp"
 
-#include <iostream>
+#include "logging/log.hpp"
 
 void VacuumRobot::moveTo(Position dst) {
     if (state_ != RobotState::IDLE && state_ != RobotState::ARRIVED) {
-        std::cout << "[Vacuum#" << name_ << "] busy, ignore move\n";
+        LOG_WARN("[Vacuum#", name_, "] busy, ignore move");
         return;
     }
-    state_ = RobotState::MOVING;
-    std::cout << "[Vacuum#" << name_ << "] start moving toward (" << dst.x << "," << dst.y << ")\n";
-    pos_ = dst;
-    state_ = RobotState::ARRIVED;
-    publishStatus();
+    LOG_DEBUG("[Vacuum#", name_, "] start moving toward (", dst.x, ",", dst.y, ")");
+    travelTo(dst);
 }
 
-void VacuumRobot::startWork(const std::string& kind) {
+void VacuumRobot::startWork(WorkKind kind) {
     if (state_ != RobotState::ARRIVED && state_ != RobotState::IDLE) { return; }
-    state_ = RobotState::WORKING;
-    std::cout << "[Vacuum#" << name_ << "] start vacuuming\n";
-    state_ = RobotState::IDLE;
-    publishWorkCompleted(kind.empty() ? "VACUUM" : kind, true);
+    LOG_DEBUG("[Vacuum#", name_, "] start vacuuming");
+    performWork(kind == WorkKind::NONE ? WorkKind::VACUUM : kind);
 }
 
 void VacuumRobot::stop() {
-    state_ = RobotState::IDLE;
+    setState(RobotState::IDLE);
     publishStatus();
 }
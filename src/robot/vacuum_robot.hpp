@@ -9,6 +9,6 @@ public:
         : RobotBase(std::move(name), RobotType::VACUUM, start) {}
 
     void moveTo(Position dst) override;
-    void startWork(const std::string& kind) override;
+    void startWork(WorkKind kind) override;
     void stop() override;
 };
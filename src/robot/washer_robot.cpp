@@ -1,28 +1,23 @@
 #include "robot/washer_robot.hpp"
 
-#include <iostream>
+#include "logging/log.hpp"
 
 void WasherRobot::moveTo(Position dst) {
     if (state_ != RobotState::IDLE && state_ != RobotState::ARRIVED) {
-        std::cout << "[Washer#" << name_ << "] busy, ignore move\n";
+        LOG_WARN("[Washer#", name_, "] busy, ignore move");
         return;
     }
-    state_ = RobotState::MOVING;
-    std::cout << "[Washer#" << name_ << "] start moving toward (" << dst.x << "," << dst.y << ")\n";
-    pos_ = dst;
-    state_ = RobotState::ARRIVED;
-    publishStatus();
+    LOG_DEBUG("[Washer#", name_, "] start moving toward (", dst.x, ",", dst.y, ")");
+    travelTo(dst);
 }
 
-void WasherRobot::startWork(const std::string& kind) {
+void WasherRobot::startWork(WorkKind kind) {
     if (state_ != RobotState::ARRIVED && state_ != RobotState::IDLE) { return; }
-    state_ = RobotState::WORKING;
-    std::cout << "[Washer#" << name_ << "] start washing\n";
-    state_ = RobotState::IDLE;
-    publishWorkCompleted(kind.empty() ? "WASH" : kind, true);
+    LOG_DEBUG("[Washer#", name_, "] start washing");
+    performWork(kind == WorkKind::NONE ? WorkKind::WASH : kind);
 }
 
 void WasherRobot::stop() {
-    state_ = RobotState::IDLE;
+    setState(RobotState::IDLE);
     publishStatus();
 }
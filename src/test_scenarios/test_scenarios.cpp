@@ -6,14 +6,30 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <unistd.h>
 
 #include "robot/detector_robot.hpp"
 #include "robot/vacuum_robot.hpp"
 #include "robot/washer_robot.hpp"
 #include "registry/registry.hpp"
+#include "bus/bus.hpp"
+#include "bus/event_ring.hpp"
 #include "environment/environment_map.hpp"
+#include "environment/feed_file.hpp"
 #include "control_unit/control_unit.hpp"
+#include "control_unit/checkpoint.hpp"
+#include "control_unit/run_metrics.hpp"
 #include "common/bootstrap.hpp"
+#include "planner/planner.hpp"
+#include "registry/nearest_idle_kernel.hpp"
+#include "common/idle_robot_index.hpp"
 #include "test_scenarios/test_scenarios.hpp"
 
 using std::cout;
@@ -198,6 +214,709 @@ static void scenario_duplicate_spots() {
     cout << "[Result] Expected: either deduplication or repeated handling per policy;\n";
 }
 
+// ---------- Scenario 8: Sparse map storage ----------
+static void scenario_sparse_storage() {
+    divider("Storage: sparse map backend on a wide, mostly-clean floor");
+    RobotRegistry registry;
+
+    auto d1 = std::make_shared<DetectorRobot>("d1", Position{0,0});
+    auto v1 = std::make_shared<VacuumRobot  >("v1", Position{0,0});
+    auto w1 = std::make_shared<WasherRobot  >("w1", Position{0,0});
+    registry.add(d1); registry.add(v1); registry.add(w1);
+
+    BootstrapFeed feed = makeFeed({ Position{1,1}, Position{38,2}, Position{20,0} });
+    feed.gridWidth = 40;
+    feed.gridHeight = 3;
+    feed.storage = MapStorage::SPARSE;
+
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(feed);
+    cu.run();
+    cout << "[Result] Expected: same lifecycle as the dense map; remaining non-clean cells = "
+         << (map.cellCount() - map.countCells(CellState::CLEAN)) << " (expected 0).\n";
+}
+
+// ---------- Scenario 9: Batch assignment ----------
+static void scenario_batch_assignment() {
+    divider("Optimization: batch (min-total-distance) assignment, 3 Vacuums vs 6 queued spots");
+    RobotRegistry registry;
+
+    auto d1 = std::make_shared<DetectorRobot>("d1", Position{0,0});
+    auto v1 = std::make_shared<VacuumRobot  >("v1", Position{0,0});
+    auto v2 = std::make_shared<VacuumRobot  >("v2", Position{9,0});
+    auto v3 = std::make_shared<VacuumRobot  >("v3", Position{9,5});
+    auto w1 = std::make_shared<WasherRobot  >("w1", Position{0,5});
+    registry.add(d1);
+    registry.add(v1); registry.add(v2); registry.add(v3);
+    registry.add(w1);
+
+    BootstrapFeed feed = makeFeed({
+        Position{1, 0}, Position{8, 0}, Position{8, 5},
+        Position{2, 1}, Position{7, 1}, Position{7, 4}
+    });
+
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.setAssignmentPolicy(AssignmentPolicy::BATCH);
+    cu.seedFrom(feed);
+    cu.run();
+    cout << "[Result] Expected: every spot cleaned; compare the travel distance with the greedy runs above.\n";
+}
+
+// ---------- Scenario 10: Coverage patterns ----------
+static void scenario_coverage_patterns() {
+    divider("Planner: coverage pattern path lengths (19x9 floor, 2 detectors), then spiral + hilbert run");
+
+    Planner planner;
+    planner.configureGrid(19, 9);
+    for (const auto& name : PatternRegistry::builtin().names()) {
+        planner.setPatterns({name});
+        long long total = 0;
+        for (long long length : planner.planPathLengths(2)) {
+            total += length;
+        }
+        cout << "[Planner] " << name << ": total path length " << total << "\n";
+    }
+
+    RobotRegistry registry;
+    auto d1 = std::make_shared<DetectorRobot>("d1", Position{0,0});
+    auto d2 = std::make_shared<DetectorRobot>("d2", Position{0,0});
+    auto v1 = std::make_shared<VacuumRobot  >("v1", Position{0,0});
+    auto w1 = std::make_shared<WasherRobot  >("w1", Position{0,0});
+    registry.add(d1); registry.add(d2); registry.add(v1); registry.add(w1);
+
+    BootstrapFeed feed = makeFeed({ Position{0,8}, Position{9,4}, Position{18,0} });
+    feed.scanPatterns = {"spiral", "hilbert"};
+
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(feed);
+    cu.run();
+    cout << "[Result] Expected: serpentine/spiral shortest, row-wise/column-wise longest; all 3 spots cleaned.\n";
+}
+
+// ---------- Scenario 11: Pipelined execution ----------
+static void scenario_pipelined() {
+    divider("Concurrency: pipelined run (detector / vacuum / washer stages on separate threads)");
+    RobotRegistry registry;
+
+    auto d1 = std::make_shared<DetectorRobot>("d1", Position{0,0});
+    auto d2 = std::make_shared<DetectorRobot>("d2", Position{0,0});
+    auto v1 = std::make_shared<VacuumRobot  >("v1", Position{0,0});
+    auto v2 = std::make_shared<VacuumRobot  >("v2", Position{11,5});
+    auto w1 = std::make_shared<WasherRobot  >("w1", Position{0,0});
+    registry.add(d1); registry.add(d2);
+    registry.add(v1); registry.add(v2);
+    registry.add(w1);
+
+    std::vector<Position> spots;
+    for (int i = 0; i < 12; ++i) {
+        spots.push_back(Position{ i, (i * 7) % 6 });
+    }
+    BootstrapFeed feed = makeFeed(spots);
+
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.setExecutionMode(ExecutionMode::PIPELINED);
+    cu.seedFrom(feed);
+    cu.run();
+    cout << "[Result] Expected: log lines of the stages interleave; remaining non-clean cells = "
+         << (map.cellCount() - map.countCells(CellState::CLEAN)) << " (expected 0).\n";
+}
+
+// ---------- Scenario 12: Binary wire format ----------
+
+// encode -> decode one message and compare it field by field (via the expected bytes of a re-encode)
+template<typename Message>
+static bool wireRoundTrip(const char* name, const Message& original, std::size_t expectedSize) {
+    std::uint8_t buf[kMaxWireSize] = {};
+    const std::size_t size = encode(original, buf);
+
+    Message decoded{};
+    bool ok = size == expectedSize && decode(buf, size, decoded);
+    // the decoded value must encode to the very same bytes and print the same way
+    std::uint8_t again[kMaxWireSize] = {};
+    ok = ok && encode(decoded, again) == size && std::memcmp(buf, again, size) == 0;
+    ok = ok && toString(decoded) == toString(original);
+    // truncated frames and frames of another type must be rejected
+    ok = ok && !decode(buf, size - 1, decoded);
+    MessageTag tag{};
+    ok = ok && peekTag(buf, size, tag) && static_cast<std::uint8_t>(tag) == buf[0];
+    buf[0] = static_cast<std::uint8_t>(buf[0] == static_cast<std::uint8_t>(MessageTag::TICK) ? MessageTag::STOP : MessageTag::TICK);
+    ok = ok && !decode(buf, size, decoded);
+
+    cout << "[Wire] " << name << " (" << size << " bytes): " << (ok ? "PASS" : "FAIL") << "\n";
+    return ok;
+}
+
+static void scenario_wire_round_trip() {
+    divider("Messages: binary wire format round-trip");
+
+    StatusEvent status;
+    status.from = 7; status.type = RobotType::WASHER; status.state = RobotState::ARRIVED; status.position = {-3, 123456};
+    WorkCompletedEvent done;
+    done.from = 42; done.workKind = WorkKind::VACUUM; done.success = false; done.position = {5, 6};
+    StartWorkCommand start;
+    start.to = 9; start.kind = WorkKind::WASH;
+    TickCommand tick;
+    tick.to = 5; tick.now = 0x0123456789abcdefULL;
+
+    bool ok = true;
+    ok = wireRoundTrip("DetectionEvent", DetectionEvent{3, {1, 2}}, 13) && ok;
+    ok = wireRoundTrip("StatusEvent", status, 15) && ok;
+    ok = wireRoundTrip("WorkCompletedEvent", done, 15) && ok;
+    ok = wireRoundTrip("MoveCommand", MoveCommand{11, {2147483647, -2147483647 - 1}}, 13) && ok;
+    ok = wireRoundTrip("StartWorkCommand", start, 6) && ok;
+    ok = wireRoundTrip("StopCommand", StopCommand{12}, 5) && ok;
+    ok = wireRoundTrip("TickCommand", tick, 13) && ok;
+
+    // out-of-range enum values are rejected
+    std::uint8_t buf[kMaxWireSize] = {};
+    const std::size_t size = encode(status, buf);
+    buf[6] = 200;
+    StatusEvent bad;
+    ok = !decode(buf, size, bad) && ok;
+
+    cout << "[Result] Expected: all PASS; overall " << (ok ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 13: Message text formatting ----------
+template<typename Message>
+static bool formatsAs(const Message& message, const std::string& expected) {
+    char buf[kMaxMessageText];
+    const std::size_t size = toChars(message, buf, sizeof(buf));
+    bool ok = std::string(buf, size) == expected && toString(message) == expected;
+    // a short buffer gets a truncated prefix, never more than it can hold
+    char small[10];
+    const std::size_t cut = toChars(message, small, sizeof(small));
+    ok = ok && cut <= sizeof(small) && expected.compare(0, cut, small, cut) == 0;
+    cout << "[Format] " << expected << ": " << (ok ? "PASS" : "FAIL") << "\n";
+    return ok;
+}
+
+static void scenario_message_format() {
+    divider("Messages: allocation-free text formatting");
+
+    StatusEvent status;
+    status.from = 7; status.type = RobotType::WASHER; status.state = RobotState::ARRIVED; status.position = {-3, 123456};
+    WorkCompletedEvent done;
+    done.from = 42; done.workKind = WorkKind::VACUUM; done.success = false; done.position = {5, 6};
+    TickCommand tick;
+    tick.now = 18446744073709551615ULL;
+
+    bool ok = true;
+    ok = formatsAs(DetectionEvent{3, {1, 2}}, "[DetectionEvent] from=3 position=(1,2)") && ok;
+    ok = formatsAs(status, "[StatusEvent] from=7 type=2 state=2 position=(-3,123456)") && ok;
+    ok = formatsAs(done, "[WorkCompletedEvent] from=42 kind=VACUUM position=(5,6) ok=false") && ok;
+    ok = formatsAs(MoveCommand{11, {2147483647, -2147483647 - 1}}, "[MoveCommand] to=11 position=(2147483647,-2147483648)") && ok;
+    ok = formatsAs(StartWorkCommand{9, WorkKind::WASH}, "[StartWorkCommand] to=9 kind=WASH") && ok;
+    ok = formatsAs(StopCommand{12}, "[StopCommand] to=12") && ok;
+    ok = formatsAs(tick, "[TickCommand] to=0 now=18446744073709551615") && ok;
+
+    cout << "[Result] Expected: all PASS; overall " << (ok ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 14: Registry removal ----------
+static void scenario_registry_removal() {
+    divider("Registry: dense views and fleet state stay compact and ordered across removals");
+    RobotRegistry registry;
+
+    auto d1 = std::make_shared<DetectorRobot>("d1", Position{0,0});
+    auto v1 = std::make_shared<VacuumRobot  >("v1", Position{0,0});
+    auto v2 = std::make_shared<VacuumRobot  >("v2", Position{4,4});
+    auto v3 = std::make_shared<VacuumRobot  >("v3", Position{9,9});
+    auto w1 = std::make_shared<WasherRobot  >("w1", Position{0,0});
+    registry.add(d1); registry.add(v1); registry.add(v2); registry.add(v3); registry.add(w1);
+
+    bool ok = registry.remove(v2->id()) && !registry.remove(v2->id());
+    ok = ok && registry.find(v2->id()) == nullptr && registry.find(v3->id()) == v3.get();
+    const RobotRange vacuums = registry.ofType(RobotType::VACUUM);
+    ok = ok && vacuums.size() == 2 && vacuums[0] == v1.get() && vacuums[1] == v3.get();
+    ok = ok && registry.size() == 4 && registry.all()[2] == v3.get() && registry.all()[3] == w1.get();
+    ok = ok && registry.add(v2) && registry.ofType(RobotType::VACUUM)[2] == v2.get();
+    ok = ok && registry.remove(d1->id()) && registry.ofType(RobotType::DETECTOR).empty();
+    cout << "[Registry] views after removals: " << (ok ? "PASS" : "FAIL") << "\n";
+
+    // the fleet left over still runs
+    registry.add(d1);
+    BootstrapFeed feed = makeFeed({ Position{2,2}, Position{7,1} });
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(feed);
+    cu.run();
+
+    // the fleet state table mirrors every robot, and answers range queries from it
+    const FleetState& fleet = registry.fleet();
+    bool mirrored = fleet.size() == registry.size();
+    for (std::size_t slot = 0; mirrored && slot < fleet.size(); ++slot) {
+        const RobotBase* robot = registry.all()[slot];
+        mirrored = fleet.id(slot) == robot->id() && fleet.state(slot) == robot->state()
+                && fleet.position(slot).x == robot->position().x && fleet.position(slot).y == robot->position().y;
+    }
+    std::vector<RobotId> nearby;
+    mirrored = mirrored && fleet.idleWithin(RobotType::VACUUM, Position{2,2}, 0, nearby) == 1 && nearby[0] == v1->id();
+    mirrored = mirrored && fleet.idleWithin(RobotType::WASHER, Position{0,0}, 1000, nearby) == 1;
+    cout << "[Registry] fleet state mirrors the robots: " << (mirrored ? "PASS" : "FAIL") << "\n";
+    const std::size_t firstRemaining = map.cellCount() - map.countCells(CellState::CLEAN);
+
+    // removing robots while the control unit is live: the bus must not reach them afterwards,
+    // even once the last reference is gone and even through broadcast ticks
+    const Position parked = v1->position();
+    bool detached = cu.removeRobot(v1->id()) && cu.removeRobot(v3->id()) && !cu.removeRobot(v3->id());
+    const RobotId goneId = v3->id();
+    v3.reset();
+    cu.setSimulationMode(SimulationMode::TIME_STEPPED);
+    cu.seedFrom(makeFeed({ Position{2,2}, Position{7,1}, Position{5,5} }));
+    cu.run();
+    detached = detached && registry.find(goneId) == nullptr && registry.fleet().size() == registry.size()
+            && v1->state() == RobotState::IDLE && v1->position().x == parked.x && v1->position().y == parked.y
+            && map.countCells(CellState::CLEAN) == map.cellCount();
+    cout << "[Registry] robots removed through the live control unit stay out of the run: "
+         << (detached ? "PASS" : "FAIL") << "\n";
+    cout << "[Result] Expected: PASS; both spots cleaned (remaining: " << firstRemaining << ").\n";
+}
+
+// ---------- Scenario 15: Vectorized nearest-idle kernel ----------
+static void scenario_nearest_idle_kernel() {
+    divider("Fleet: vectorized nearest-idle kernel agrees with the scalar path");
+
+    // pseudo-random fleet with a few robots at the extremes of the coordinate range,
+    // where 32-bit distances saturate and the exact fallback has to decide
+    std::vector<std::int32_t> xs, ys;
+    std::vector<RobotType> types;
+    std::vector<RobotState> states;
+    std::uint32_t seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    for (int i = 0; i < 1003; ++i) {
+        const bool extreme = i % 97 == 0;
+        xs.push_back(extreme ? (i % 2 ? 2147483647 : -2147483647 - 1) : static_cast<std::int32_t>(next() % 2000) - 1000);
+        ys.push_back(extreme ? -2147483647 - 1 : static_cast<std::int32_t>(next() % 2000) - 1000);
+        types.push_back(static_cast<RobotType>(next() % 3));
+        states.push_back(next() % 2 ? RobotState::IDLE : RobotState::WORKING);
+    }
+
+    bool ok = true;
+    const Position targets[] = {{0, 0}, {-999, 999}, {2147483647, 2147483647}, {-2147483647 - 1, 0}};
+    for (std::size_t n : {std::size_t{0}, std::size_t{5}, std::size_t{13}, xs.size()}) {
+        const FleetColumns columns{xs.data(), ys.data(), types.data(), states.data(), n};
+        for (const Position& target : targets) {
+            for (RobotType type : {RobotType::DETECTOR, RobotType::VACUUM, RobotType::WASHER}) {
+                const std::size_t expected = nearestIdleSlot(columns, type, target, KernelPath::SCALAR);
+                ok = ok && nearestIdleSlot(columns, type, target, KernelPath::SSE41) == expected;
+                ok = ok && nearestIdleSlot(columns, type, target, KernelPath::AVX2) == expected;
+            }
+        }
+    }
+    cout << "[Kernel] best path: " << kernelPathName(bestKernelPath()) << "\n";
+    cout << "[Result] Expected: all paths pick the same robot; " << (ok ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 16: Timed simulation (time-stepped and event-driven) ----------
+
+// run one small timed fleet; returns the number of cells left unclean
+static std::size_t runTimedFleet(SimulationMode mode, SimulationStats& stats) {
+    RobotRegistry registry;
+
+    auto d1 = std::make_shared<DetectorRobot>("d1", Position{0,0});
+    auto d2 = std::make_shared<DetectorRobot>("d2", Position{0,0});
+    auto v1 = std::make_shared<VacuumRobot  >("v1", Position{0,0});
+    auto v2 = std::make_shared<VacuumRobot  >("v2", Position{11,7});
+    auto w1 = std::make_shared<WasherRobot  >("w1", Position{0,0});
+    registry.add(d1); registry.add(d2);
+    registry.add(v1); registry.add(v2);
+    registry.add(w1);
+
+    BootstrapFeed feed = makeFeed({
+        Position{1,1}, Position{10,1}, Position{5,4}, Position{2,6}, Position{11,7}, Position{6,6}
+    });
+
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(feed);
+    cu.setSimulationMode(mode);
+    cu.setRobotTiming(RobotType::DETECTOR, RobotTiming{2, 0});
+    cu.setRobotTiming(RobotType::VACUUM, RobotTiming{1, 3});
+    cu.setRobotTiming(RobotType::WASHER, RobotTiming{2, 4});
+    cu.run();
+
+    stats = cu.simulationStats();
+    return map.cellCount() - map.countCells(CellState::CLEAN);
+}
+
+static void scenario_time_stepped() {
+    divider("Simulation: time-stepped robots with travel time and work duration");
+    SimulationStats stats;
+    const std::size_t remaining = runTimedFleet(SimulationMode::TIME_STEPPED, stats);
+
+    bool ok = stats.makespan > 0 && stats.tasksDispatched == 12;
+    for (double u : stats.utilization) {
+        ok = ok && u > 0.0 && u <= 1.0;
+    }
+    cout << "[Result] Expected: every spot cleaned (remaining: " << remaining << "), 12 tasks timed; "
+         << (ok ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 17: Event-driven simulation ----------
+static void scenario_event_driven() {
+    divider("Simulation: event-driven clock matches the time-stepped schedule");
+    SimulationStats stepped;
+    SimulationStats events;
+    runTimedFleet(SimulationMode::TIME_STEPPED, stepped);
+    const std::size_t remaining = runTimedFleet(SimulationMode::EVENT_DRIVEN, events);
+
+    bool ok = events.makespan == stepped.makespan && events.tasksDispatched == stepped.tasksDispatched
+           && events.maxQueueWait == stepped.maxQueueWait && events.meanQueueWait == stepped.meanQueueWait;
+    for (std::size_t i = 0; i < events.utilization.size(); ++i) {
+        ok = ok && events.utilization[i] == stepped.utilization[i];
+    }
+    cout << "[Result] Expected: every spot cleaned (remaining: " << remaining
+         << "), same makespan/utilization/waits as time-stepped; " << (ok ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 18: Binary feed files ----------
+static bool sameCells(const EnvironmentMap& a, const EnvironmentMap& b) {
+    if (a.width() != b.width() || a.height() != b.height() || a.storage() != b.storage()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            if (a.cellAt({x, y}) != b.cellAt({x, y})) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void scenario_feed_files() {
+    divider("Bootstrap: binary feed files load the same floor as the in-memory feed");
+    const std::string base = "/tmp/cleaning_robots_feed_" + std::to_string(::getpid());
+    const std::string feedPath = base + ".feed";
+    const std::string textPath = base + ".txt";
+
+    BootstrapFeed feed;
+    feed.gridWidth = 37;
+    feed.gridHeight = 11;
+    feed.dirtSpots = { {0,0}, {36,10}, {5,3}, {5,3}, {17,0}, {0,10}, {20,6}, {36,0} };
+    EnvironmentMap expected;
+    expected.initializeGrid(feed.gridWidth, feed.gridHeight, feed.dirtSpots);
+
+    bool ok = true;
+    for (FeedEncoding encoding : {FeedEncoding::CELL_INDEX32, FeedEncoding::CELL_INDEX64, FeedEncoding::BITMAP}) {
+        EnvironmentMap loaded;
+        ok = ok && writeFeedFile(feedPath, feed, encoding) && FeedFile::open(feedPath).loadInto(loaded)
+                && sameCells(expected, loaded);
+    }
+    cout << "[Feed] index and bitmap encodings round-trip: " << (ok ? "PASS" : "FAIL") << "\n";
+
+    // a fully dirty floor has more spots than its bitmap has bytes; the smallest encoding must still read back
+    BootstrapFeed dense;
+    dense.gridWidth = 16;
+    dense.gridHeight = 16;
+    for (int y = 0; y < dense.gridHeight; ++y) {
+        for (int x = 0; x < dense.gridWidth; ++x) {
+            dense.dirtSpots.push_back({x, y});
+        }
+    }
+    EnvironmentMap denseExpected;
+    denseExpected.initializeGrid(dense.gridWidth, dense.gridHeight, dense.dirtSpots);
+    const FeedEncoding smallest = smallestFeedEncoding(dense.gridWidth, dense.gridHeight, dense.dirtSpots.size());
+    EnvironmentMap denseLoaded;
+    const FeedFile denseFile = writeFeedFile(feedPath, dense, smallest) ? FeedFile::open(feedPath) : FeedFile{};
+    const bool denseOk = smallest == FeedEncoding::BITMAP && denseFile.spotCount() == dense.dirtSpots.size()
+                      && denseFile.loadInto(denseLoaded) && sameCells(denseExpected, denseLoaded);
+    ok = ok && denseOk;
+    cout << "[Feed] fully dirty floor round-trips as a bitmap: " << (denseOk ? "PASS" : "FAIL") << "\n";
+
+    // text feed -> binary feed, with comments, blank lines and a SPARSE storage hint
+    {
+        std::ofstream text(textPath);
+        text << "# survey 2026-10\n37 11\n";
+        for (const Position& p : feed.dirtSpots) {
+            text << p.x << " " << p.y << "   # spot\n";
+        }
+        text << "\n";
+    }
+    EnvironmentMap sparseExpected;
+    sparseExpected.initializeGrid(feed.gridWidth, feed.gridHeight, feed.dirtSpots, MapStorage::SPARSE);
+    EnvironmentMap converted;
+    bool textOk = convertTextFeed(textPath, feedPath, FeedEncoding::CELL_INDEX32, MapStorage::SPARSE)
+               && FeedFile::open(feedPath).loadInto(converted) && sameCells(sparseExpected, converted);
+    // a spot off the floor fails the conversion and leaves no file behind
+    std::ofstream(textPath) << "4 4\n1 1\n4 0\n";
+    textOk = textOk && !convertTextFeed(textPath, feedPath, FeedEncoding::BITMAP) && !std::ifstream(feedPath).good();
+    cout << "[Feed] text conversion: " << (textOk ? "PASS" : "FAIL") << "\n";
+
+    // and the control unit cleans a floor seeded from a file
+    writeFeedFile(feedPath, feed, smallestFeedEncoding(feed.gridWidth, feed.gridHeight, feed.dirtSpots.size()));
+    RobotRegistry registry;
+    registry.add(std::make_shared<DetectorRobot>("d1", Position{0,0}));
+    registry.add(std::make_shared<VacuumRobot  >("v1", Position{0,0}));
+    registry.add(std::make_shared<WasherRobot  >("w1", Position{0,0}));
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    const bool seeded = cu.seedFromFile(feedPath);
+    cu.run();
+    std::remove(feedPath.c_str());
+    std::remove(textPath.c_str());
+
+    const std::size_t remaining = map.cellCount() - map.countCells(CellState::CLEAN);
+    cout << "[Result] Expected: every spot cleaned (remaining: " << remaining << "); "
+         << (ok && textOk && seeded && remaining == 0 && map.width() == 37 ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 19: Checkpoint and restart ----------
+static void scenario_checkpoint_restore() {
+    divider("Checkpoint: a restarted control unit resumes from the snapshot instead of rescanning");
+    const std::string path = "/tmp/cleaning_robots_checkpoint_" + std::to_string(::getpid());
+    auto makeFleet = [](RobotRegistry& registry) {
+        registry.add(std::make_shared<DetectorRobot>("d1", Position{0,0}));
+        registry.add(std::make_shared<VacuumRobot  >("v1", Position{0,0}));
+        registry.add(std::make_shared<WasherRobot  >("w1", Position{0,0}));
+    };
+
+    // a run that writes snapshots along the way ends with one that has nothing left to do
+    bool ok = true;
+    {
+        RobotRegistry registry;
+        makeFleet(registry);
+        EnvironmentMap map;
+        ControlUnit cu{registry, map};
+        cu.seedFrom(makeFeed({ Position{1,1}, Position{6,2}, Position{3,3} }));
+        cu.setCheckpoint(path, 4);
+        cu.run();
+        EnvironmentMap restored;
+        CheckpointState state;
+        ok = readCheckpoint(path, restored, state) && restored.width() == 7 && restored.height() == 4
+          && restored.countCells(CellState::CLEAN) == restored.cellCount() && state.vacuumQueue.empty()
+          && state.washerQueue.empty() && state.detectorProgress.size() == 1 && state.detectorProgress[0] == 28
+          && state.patterns == std::vector<std::string>{"serpentine"};
+    }
+    cout << "[Checkpoint] final snapshot of a finished run: " << (ok ? "PASS" : "FAIL") << "\n";
+
+    // a process that died with rows 0-1 of a 10x4 floor scanned: (5,0) waiting for a vacuum,
+    // (3,1) vacuumed and waiting for a washer. (8,0) is dirty but was never queued, so a resumed
+    // run must leave it alone; (2,3) lies in the unscanned half and must still be found.
+    {
+        EnvironmentMap map;
+        map.resetGrid(10, 4);
+        map.addDirt(Position{5,0});
+        map.addDirt(Position{8,0});
+        map.addDirt(Position{2,3});
+        map.addCell(13, CellState::VACUUMED);
+        CheckpointState state;
+        state.patterns = {"serpentine"};
+        state.vacuumQueue = { Position{5,0} };
+        state.washerQueue = { Position{3,1} };
+        state.detectorProgress = { 20 };
+        ok = writeCheckpoint(path, map, state);
+    }
+    RobotRegistry registry;
+    makeFleet(registry);
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    ok = cu.restoreFrom(path) && ok;
+    cu.run();
+    std::remove(path.c_str());
+
+    const bool resumed = map.cellAt({8,0}) == CellState::DIRTY && map.cellAt({5,0}) == CellState::CLEAN
+                      && map.cellAt({3,1}) == CellState::CLEAN && map.cellAt({2,3}) == CellState::CLEAN;
+    cout << "[Result] Expected: queued cells and the unscanned half cleaned, scanned half not rescanned (remaining: "
+         << (map.cellCount() - map.countCells(CellState::CLEAN)) << " == 1); "
+         << (ok && resumed ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 20: Run metrics ----------
+static void scenario_run_metrics() {
+    divider("Metrics: latency histograms and run counters");
+
+    // every value comes back within the histogram's 1/16 relative resolution
+    LatencyHistogram histogram;
+    for (std::uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v);
+    }
+    bool ok = histogram.count() == 100000 && histogram.min() == 1 && histogram.max() == 100000
+           && histogram.mean() == 50000;
+    for (double percent : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        const auto exact = static_cast<double>(percent * 1000.0);
+        const auto reported = static_cast<double>(histogram.percentile(percent));
+        ok = ok && reported >= exact && reported <= exact * (1.0 + 1.0 / 16.0);
+    }
+    ok = ok && histogram.percentile(100.0) == 100000;
+    cout << "[Metrics] histogram percentiles: " << (ok ? "PASS" : "FAIL") << "\n";
+
+    RobotRegistry registry;
+    registry.add(std::make_shared<DetectorRobot>("d1", Position{0,0}));
+    registry.add(std::make_shared<VacuumRobot  >("v1", Position{0,0}));
+    registry.add(std::make_shared<WasherRobot  >("w1", Position{3,3}));
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(makeFeed({ Position{1,0}, Position{3,2}, Position{0,3}, Position{4,4} }));
+    cu.run();
+
+    const RunMetrics* metrics = cu.runMetrics();
+    bool counted = true;
+    if (kMetricsEnabled) {
+        const auto vacuum = static_cast<std::size_t>(RobotType::VACUUM);
+        const auto washer = static_cast<std::size_t>(RobotType::WASHER);
+        counted = metrics != nullptr && metrics->tasksQueued[vacuum] == 4 && metrics->tasksQueued[washer] == 4
+               && metrics->queueLatency[vacuum].count() == 4 && metrics->queueLatency[washer].count() == 4
+               && metrics->nearestIdleCost[vacuum].count() >= 4 && metrics->commandsSent.load() > 0
+               && metrics->eventsDrained.load() > 0;
+    } else {
+        counted = metrics == nullptr;
+    }
+    cout << "[Result] Expected: every cell counted through both queues (metrics "
+         << (kMetricsEnabled ? "on" : "compiled out") << "); " << (ok && counted ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 21: Event ring under load ----------
+static void scenario_event_ring() {
+    divider("Bus: event ring with concurrent producers and a full ring");
+
+    // a full ring refuses pushes instead of overwriting
+    EventRing<std::uint64_t> small(8);
+    bool full = true;
+    for (std::uint64_t i = 0; i < small.capacity(); ++i) {
+        full = small.tryPush(std::uint64_t{i}) && full;
+    }
+    std::vector<std::uint64_t> drained;
+    full = full && !small.tryPush(std::uint64_t{99}) && small.tryPopBatch(drained, 100) == small.capacity();
+    for (std::uint64_t i = 0; full && i < drained.size(); ++i) {
+        full = drained[i] == i;
+    }
+    cout << "[Ring] full ring rejects pushes: " << (full ? "PASS" : "FAIL") << "\n";
+
+    // producers racing on a small ring: nothing lost, each producer's items stay in order
+    constexpr std::uint64_t kProducers = 4;
+    constexpr std::uint64_t kPerProducer = 50000;
+    EventRing<std::uint64_t> ring(64);
+    std::vector<std::thread> producers;
+    for (std::uint64_t producer = 0; producer < kProducers; ++producer) {
+        producers.emplace_back([&ring, producer] {
+            for (std::uint64_t seq = 0; seq < kPerProducer; ++seq) {
+                while (!ring.tryPush(producer << 32 | seq)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<std::uint64_t> next(kProducers, 0);
+    std::vector<std::uint64_t> batch;
+    std::uint64_t received = 0;
+    bool ordered = true;
+    while (received < kProducers * kPerProducer) {
+        batch.clear();
+        if (ring.tryPopBatch(batch, 32) == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (std::uint64_t item : batch) {
+            std::uint64_t& expected = next[item >> 32];
+            ordered = ordered && (item & 0xffffffffu) == expected;
+            ++expected;
+        }
+        received += batch.size();
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    cout << "[Ring] " << kProducers << " producers x " << kPerProducer << " items: " << (ordered ? "PASS" : "FAIL") << "\n";
+
+    // robots answering a broadcast publish on the draining thread: a burst larger than the ring
+    // spills instead of waiting for a consumer that can never run
+    RobotRegistry registry;
+    for (int i = 0; i < 300; ++i) {
+        registry.add(std::make_shared<VacuumRobot>("v" + std::to_string(i), Position{i, 0}));
+    }
+    Bus bus(registry, 64);
+    std::vector<Bus::EventVariant> events;
+    bus.pollBatch(events, 1);   // this thread is the consumer
+    StopCommand stop;
+    stop.to = kBroadcastId;
+    bus.broadcast(stop);
+    std::size_t polled = 0;
+    bool inOrder = true;
+    const RobotRange vacuums = registry.ofType(RobotType::VACUUM);
+    while (bus.pollBatch(events, 100) > 0) {
+        for (const Bus::EventVariant& event : events) {
+            const StatusEvent* status = std::get_if<StatusEvent>(&event);
+            // every robot publishes its status twice, robots in broadcast order
+            inOrder = inOrder && status && status->from == vacuums[polled / 2]->id();
+            ++polled;
+        }
+    }
+    const Bus::EventStats stats = bus.eventStats();
+    const bool spilled = inOrder && polled == 2 * vacuums.size() && stats.published == polled && stats.spilled > 0;
+    cout << "[Bus] burst of " << polled << " events on a " << stats.capacity << "-slot ring: "
+         << (spilled ? "PASS" : "FAIL") << "\n";
+    cout << "[Result] Expected: all PASS; overall " << (full && ordered && spilled ? "PASS" : "FAIL") << ".\n";
+}
+
+// ---------- Scenario 22: Idle index with sparse, far-away robots ----------
+static void scenario_sparse_idle_index() {
+    divider("Idle index: sparse robots far from the target");
+
+    // robots that went busy leave the bounding box wide open; the few idle ones are far away
+    IdleRobotIndex index;
+    for (int i = 0; i < 64; ++i) {
+        index.insert(static_cast<RobotId>(100 + i), Position{-1000000 + i, 1000000});
+    }
+    for (int i = 0; i < 64; ++i) {
+        index.remove(static_cast<RobotId>(100 + i));
+    }
+    const std::vector<std::pair<RobotId, Position>> idle = {
+        {7, {500000, -500000}}, {3, {-500000, 500000}}, {9, {499990, -499990}}};
+    for (const auto& [id, pos] : idle) {
+        index.insert(id, pos);
+    }
+
+    bool ok = true;
+    const Position targets[] = {{0, 0}, {400000, -400000}, {-1000000, 1000000}};
+    for (const Position& target : targets) {
+        RobotId expected = 0;
+        int bestDistance = std::numeric_limits<int>::max();
+        for (const auto& [id, pos] : idle) {
+            const int dist = manhattan(pos, target);
+            if (dist < bestDistance || (dist == bestDistance && id < expected)) {
+                bestDistance = dist;
+                expected = id;
+            }
+        }
+        RobotId nearby = 0, scanned = 0, found = 0;
+        ok = ok && index.findNearby(target, nearby) == IdleRobotIndex::Lookup::TOO_SPARSE;
+        ok = ok && index.nearestByScan(target, scanned) && scanned == expected;
+        ok = ok && index.nearest(target, found) && found == expected;
+    }
+    // a robot right at the target is still found by the ring search
+    RobotId id = 0;
+    index.insert(42, Position{1, 1});
+    ok = ok && index.findNearby(Position{0, 0}, id) == IdleRobotIndex::Lookup::FOUND && id == 42;
+    index.clear();
+    ok = ok && index.findNearby(Position{0, 0}, id) == IdleRobotIndex::Lookup::EMPTY && !index.nearest(Position{0, 0}, id);
+
+    // through a live CU: every vacuum is far outside the ring budget, the nearest one still gets the spot
+    RobotRegistry registry;
+    registry.add(std::make_shared<DetectorRobot>("d1", Position{0, 0}));
+    registry.add(std::make_shared<WasherRobot>("w1", Position{-40000, 0}));
+    std::vector<std::shared_ptr<VacuumRobot>> vacuums;
+    for (int i = 0; i < 20; ++i) {
+        const int distance = 90000 - 4000 * i;   // v19 is the closest
+        vacuums.push_back(std::make_shared<VacuumRobot>("v" + std::to_string(i),
+                                                        Position{i % 2 ? distance : -distance, distance}));
+        registry.add(vacuums.back());
+    }
+    EnvironmentMap map;
+    ControlUnit cu{registry, map};
+    cu.seedFrom(makeFeed({Position{2, 2}}));
+    cu.run();
+    const bool picked = manhattan(vacuums.back()->position(), Position{2, 2}) == 0 && map.countCells(CellState::CLEAN) == map.cellCount();
+    cout << "[CU] closest far-away vacuum cleans the spot: " << (picked ? "PASS" : "FAIL") << "\n";
+
+    cout << "[Result] Expected: ring search gives up, linear pass picks the nearest; " << (ok && picked ? "PASS" : "FAIL") << ".\n";
+}
+
 int run_all_scenarios() {
     cout << "Running Cleaning Robots test scenarios...\n";
 
@@ -208,6 +927,21 @@ int run_all_scenarios() {
     scenario_huge_coordinates();
     scenario_many_spots_stress();
     scenario_duplicate_spots();
+    scenario_sparse_storage();
+    scenario_batch_assignment();
+    scenario_coverage_patterns();
+    scenario_pipelined();
+    scenario_wire_round_trip();
+    scenario_message_format();
+    scenario_registry_removal();
+    scenario_nearest_idle_kernel();
+    scenario_time_stepped();
+    scenario_event_driven();
+    scenario_feed_files();
+    scenario_checkpoint_restore();
+    scenario_run_metrics();
+    scenario_event_ring();
+    scenario_sparse_idle_index();
 
     cout << "\nAll scenarios executed. Review logs above.\n";
     return 0;
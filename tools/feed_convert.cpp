@@ -0,0 +1,36 @@
+// feed_convert.cpp
+// Converts a text bootstrap feed ("width height", then one "x y" per line) into the binary feed
+// format read by ControlUnit::seedFromFile. Built with `make feed_convert`.
+
+#include <cstring>
+#include <iostream>
+
+#include "environment/feed_file.hpp"
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = nullptr;
+    FeedEncoding encoding = FeedEncoding::CELL_INDEX32;
+    MapStorage storage = MapStorage::DENSE;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bitmap") == 0) {
+            encoding = FeedEncoding::BITMAP;
+        } else if (std::strcmp(argv[i], "--index64") == 0) {
+            encoding = FeedEncoding::CELL_INDEX64;
+        } else if (std::strcmp(argv[i], "--sparse") == 0) {
+            storage = MapStorage::SPARSE;
+        } else if (!input) {
+            input = argv[i];
+        } else if (!output) {
+            output = argv[i];
+        } else {
+            input = nullptr;   // too many paths
+            break;
+        }
+    }
+    if (!input || !output) {
+        std::cerr << "usage: feed_convert [--bitmap | --index64] [--sparse] <input.txt> <output.feed>\n";
+        return 2;
+    }
+    return convertTextFeed(input, output, encoding, storage) ? 0 : 1;
+}